@@ -0,0 +1,68 @@
+/*
+ * collation_sorter.cpp
+ */
+
+#include "collation_sorter.h"
+#include <cctype>
+using namespace std;
+
+void collation_sorter::sort()
+{
+	// Size the arena once so the keys can point into it
+	size_t arenaSize = 0;
+	for(int i = 0; i < arrayLen; i++)
+	{
+		arenaSize += key_length(array[i].size());
+	}
+	arena.resize(arenaSize);
+
+	keys.resize(arrayLen);
+	char* next = arena.data();
+	for(int i = 0; i < arrayLen; i++)
+	{
+		write_key(array[i], next);
+		keys[i] = string_radix_sorter::radix_key { next, key_length(array[i].size()), i };
+		next += keys[i].length;
+	}
+
+	string_radix_sorter::radix_sort(keys.data(), arrayLen);
+
+	vector<int> source(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		source[i] = keys[i].index;
+	}
+	apply_permutation(source);
+}
+
+void collation_sorter::sort_report()
+{
+	sorter<string>::sort_report(get_name());
+}
+
+string collation_sorter::sort_key(const string& str)
+{
+	string key(key_length(str.size()), '\0');
+	write_key(str, &key[0]);
+	return key;
+}
+
+void collation_sorter::write_key(const string& str, char* destination)
+{
+	// Primary level: the bytes with case folded, so "Aarhus" and "aarhus"
+	// tie here and both come before "Abbey", which byte order puts between them
+	for(char c : str)
+	{
+		*destination++ = tolower((unsigned char)c);
+	}
+
+	// The 0 byte ends the primary level below any other byte, so a
+	// string comes before every longer string it is a prefix of
+	*destination++ = '\0';
+
+	// Secondary level: the original bytes, so upper case comes first on a tie
+	for(char c : str)
+	{
+		*destination++ = c;
+	}
+}
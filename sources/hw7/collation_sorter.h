@@ -0,0 +1,52 @@
+/*
+ * COLLATION SORTER: Time complexity - O(n * average distinguishing prefix)
+ *
+ * Sorts strings case-insensitively. Every string gets a binary sort key
+ * once, written into one shared arena: its case folded bytes, a 0 byte,
+ * then its original bytes to break ties between spellings that only
+ * differ in case. The keys are radix sorted as plain bytes, so no
+ * comparison ever folds case again
+ */
+
+#ifndef COLLATION_SORTER_H_
+#define COLLATION_SORTER_H_
+
+#include "sorter.h"
+#include "string_radix_sorter.h"
+#include <string>
+#include <vector>
+
+class collation_sorter : public sorter<std::string>
+{
+// PRIVATE DATA
+private:
+	// Sort keys of all strings back to back
+	std::vector<char> arena;
+	// Keys sorted in place of the strings, pointing into the arena
+	std::vector<string_radix_sorter::radix_key> keys;
+
+// PUBLIC INTERFACE
+public:
+	collation_sorter(int capacity) :
+		sorter<std::string>(capacity) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return "Collation Sort"; }
+
+	// Binary sort key of the string. Comparing two keys byte by byte
+	// orders the strings the way this sorter does
+	static std::string sort_key(const std::string& str);
+
+// PRIVATE UTILITIES
+private:
+	// Length of the sort key of a string of the given length
+	static int key_length(int length) { return 2 * length + 1; }
+
+	// Write the sort key of the string starting at the destination
+	static void write_key(const std::string& str, char* destination);
+};
+
+#endif /* COLLATION_SORTER_H_ */
@@ -0,0 +1,131 @@
+/*
+ * D-ARY HEAP SORTER: Time complexity - O(nlogn)
+ *
+ * Heap sort on a heap where every node has Arity children, which sit next
+ * to each other in memory. Sifting down is Floyd's bottom-up version: the
+ * hole left at the root is walked down to a leaf along the biggest
+ * children, then the value is sifted back up from there. The value
+ * almost always belongs near the bottom, so that saves the comparison
+ * against it at every level on the way down
+ */
+
+#ifndef DARY_HEAP_SORTER_H_
+#define DARY_HEAP_SORTER_H_
+
+#include "sorter.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+
+// INTERFACE
+
+template<typename Type, int Arity = 4>
+class dary_heap_sorter : public sorter<Type>
+{
+	static_assert(Arity >= 2, "A heap needs at least two children per node");
+
+public:
+	dary_heap_sorter(int capacity) :
+		sorter<Type>(capacity) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return std::to_string(Arity) + "-ary Heap Sort"; }
+
+	// Heap sort the given array of the given length in place
+	static void heap_sort(Type* array, int length);
+
+private:
+	// Restore the max heap property of the first length elements,
+	// given that only the element at rootIndex may be out of place
+	static void sift_down(Type* array, int length, int rootIndex);
+};
+
+// IMPLEMENTATION
+
+template<typename Type, int Arity>
+void dary_heap_sorter<Type, Arity>::sort()
+{
+	heap_sort(this->array, this->arrayLen);
+}
+
+template<typename Type, int Arity>
+void dary_heap_sorter<Type, Arity>::sort_report()
+{
+	sorter<Type>::sort_report(get_name());
+}
+
+template<typename Type, int Arity>
+void dary_heap_sorter<Type, Arity>::heap_sort(Type* array, int length)
+{
+	// (0 - 2) / Arity truncates to 0, so an empty range would still sift array[0]
+	if(length < 2)
+	{
+		return;
+	}
+
+	// Reorganize the entire array as a max heap, starting at the last parent
+	for(int index = (length - 2) / Arity; index >= 0; index--)
+	{
+		sift_down(array, length, index);
+	}
+
+	for(int index = length - 1; index > 0; index--)
+	{
+		// Put the root (biggest element) at the end
+		std::swap(array[0], array[index]);
+
+		// Restore the heap in front of the sorted part
+		sift_down(array, index, 0);
+	}
+}
+
+template<typename Type, int Arity>
+void dary_heap_sorter<Type, Arity>::sift_down(Type* array, int length, int rootIndex)
+{
+	Type value = std::move(array[rootIndex]);
+	int hole = rootIndex;
+
+	// Walk the hole down to a leaf, moving the biggest child up into it each time
+	for(int firstChild = Arity * hole + 1; firstChild < length; firstChild = Arity * hole + 1)
+	{
+		int lastChild = std::min(firstChild + Arity, length);
+		int largest = firstChild;
+		for(int child = firstChild + 1; child < lastChild; child++)
+		{
+			if(array[largest] < array[child])
+			{
+				largest = child;
+			}
+		}
+
+#if defined(__GNUC__)
+		// Start loading the children of the next level while this one is moved
+		if(Arity * largest + 1 < length)
+		{
+			__builtin_prefetch(array + Arity * largest + 1);
+		}
+#endif
+
+		array[hole] = std::move(array[largest]);
+		hole = largest;
+	}
+
+	// Sift the value back up from the leaf to where it belongs
+	while(hole > rootIndex)
+	{
+		int parent = (hole - 1) / Arity;
+		if(!(array[parent] < value))
+		{
+			break;
+		}
+		array[hole] = std::move(array[parent]);
+		hole = parent;
+	}
+
+	array[hole] = std::move(value);
+}
+
+#endif /* DARY_HEAP_SORTER_H_ */
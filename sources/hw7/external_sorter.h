@@ -0,0 +1,276 @@
+/*
+ * EXTERNAL SORTER: Time complexity - O(nlogn), memory bounded by a budget
+ *
+ * Sorts a file of whitespace separated values that doesn't fit in memory.
+ * The input is read in chunks that fit the budget, each chunk is sorted
+ * with an in-memory sorter and spilled to a temporary run file, and the
+ * runs are merged with a loser tree into the output file. Reading the
+ * next chunk overlaps sorting and writing the previous one
+ */
+
+#ifndef EXTERNAL_SORTER_H_
+#define EXTERNAL_SORTER_H_
+
+#include "sorter.h"
+#include "intro_sorter.h"
+#include "loser_tree.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// INTERFACE
+
+template<typename Type, template<typename> class ChunkSorter = intro_sorter>
+class external_sorter
+{
+public:
+	// Smallest I/O buffer given to any one file
+	static constexpr size_t MIN_BUFFER_BYTES = 16 * 1024;
+	// Spilling needs an input buffer, two output buffers and room for the chunks
+	static constexpr size_t MIN_MEMORY_BUDGET = 4 * MIN_BUFFER_BYTES;
+
+	// Sort using about memoryBudget bytes, with temporary runs in the given directory.
+	// Every buffer comes out of the budget, which must be at least MIN_MEMORY_BUDGET
+	external_sorter(size_t memoryBudget, const std::string& tempDirectory =
+			std::filesystem::temp_directory_path().string());
+
+	// Sort the values in the input file into the output file, one per line
+	void sort_file(const char* inputFile, const char* outputFile);
+
+	void set_memory_budget(size_t budget);
+
+	// Most runs merged in one pass: one buffer per run plus the output
+	// buffer must fit the budget. More runs take several passes
+	int max_fan_in() const { return memoryBudget / MIN_BUFFER_BYTES - 1; }
+
+	// Number of runs the last sort spilled before merging
+	int get_run_count() const { return runCount; }
+
+private:
+	// Buffered input file that holds its own buffer
+	struct buffered_input
+	{
+		std::vector<char> buffer;
+		std::ifstream in;
+		Type head;	// Next value of the file
+
+		buffered_input(const std::string& filename, size_t bufferBytes);
+
+		// Read the next value into head, return false at the end of the file
+		bool advance() { return bool(in >> head); }
+	};
+
+	// Buffered output file that holds its own buffer
+	struct buffered_output
+	{
+		std::vector<char> buffer;
+		std::ofstream out;
+
+		buffered_output(const std::string& filename, size_t bufferBytes);
+	};
+
+	// Names of temporary run files, removed when the holder goes away
+	// so that a sort that throws leaves no runs behind
+	struct run_files
+	{
+		std::vector<std::string> names;
+
+		run_files() = default;
+		run_files(const run_files&) = delete;
+		run_files& operator=(const run_files&) = delete;
+		~run_files();
+	};
+
+	size_t memoryBudget;	// Bytes the sort may use for elements and buffers
+	std::string tempDirectory;	// Directory the runs are written to
+	int runCount;	// Runs spilled by the last sort
+	int nextRunId;	// Used to give every run file a new name
+
+	// Return the name of a new temporary run file
+	std::string new_run_name();
+
+	// Read, sort and spill the input in chunks, adding each run file to the given runs
+	void spill_runs(const char* inputFile, run_files& runs);
+
+	// Merge the given runs into the output file
+	void merge_runs(const std::vector<std::string>& runs, const std::string& outputFile);
+};
+
+// IMPLEMENTATION
+
+template<typename Type, template<typename> class ChunkSorter>
+external_sorter<Type, ChunkSorter>::buffered_input::buffered_input(const std::string& filename, size_t bufferBytes) :
+	buffer(bufferBytes)
+{
+	// The buffer has to be installed before the file is opened
+	in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	in.open(filename);
+	if(!in.is_open())
+	{
+		throw std::invalid_argument("For input string " + filename + ": could not open file with name");
+	}
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+external_sorter<Type, ChunkSorter>::buffered_output::buffered_output(const std::string& filename, size_t bufferBytes) :
+	buffer(bufferBytes)
+{
+	out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+	out.open(filename);
+	if(!out.is_open())
+	{
+		throw std::invalid_argument("For input string " + filename + ": could not open file with name");
+	}
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+external_sorter<Type, ChunkSorter>::run_files::~run_files()
+{
+	for(const std::string& name : names)
+	{
+		std::remove(name.c_str());
+	}
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+external_sorter<Type, ChunkSorter>::external_sorter(size_t memoryBudget, const std::string& tempDirectory) :
+	tempDirectory(tempDirectory), runCount(0), nextRunId(0)
+{
+	set_memory_budget(memoryBudget);
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+void external_sorter<Type, ChunkSorter>::set_memory_budget(size_t budget)
+{
+	if(budget < MIN_MEMORY_BUDGET)
+	{
+		throw std::invalid_argument("For input budget " + std::to_string(budget) +
+				": the memory budget must be at least " + std::to_string(MIN_MEMORY_BUDGET) + " bytes");
+	}
+	memoryBudget = budget;
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+void external_sorter<Type, ChunkSorter>::sort_file(const char* inputFile, const char* outputFile)
+{
+	std::unique_ptr<run_files> runs(new run_files);
+	spill_runs(inputFile, *runs);
+	runCount = runs->names.size();
+
+	// Merge the runs in passes of at most max_fan_in() runs until one pass finishes them.
+	// Each pass's inputs are removed once the holder of the next pass replaces them
+	int fanIn = max_fan_in();
+	while((int)runs->names.size() > fanIn)
+	{
+		std::unique_ptr<run_files> merged(new run_files);
+		for(int first = 0; first < (int)runs->names.size(); first += fanIn)
+		{
+			int last = std::min<int>(first + fanIn, runs->names.size());
+			std::vector<std::string> group(runs->names.begin() + first, runs->names.begin() + last);
+			merged->names.push_back(new_run_name());
+			merge_runs(group, merged->names.back());
+		}
+		runs = std::move(merged);
+	}
+
+	merge_runs(runs->names, outputFile);
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+std::string external_sorter<Type, ChunkSorter>::new_run_name()
+{
+	// Tell apart runs of sorters running at the same time by their process
+	// and, within the process, by their address
+	return (std::filesystem::path(tempDirectory) / ("external_sort_" + std::to_string(getpid()) + "_" +
+			std::to_string((unsigned long long)this) + "_" + std::to_string(nextRunId++) + ".run")).string();
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+void external_sorter<Type, ChunkSorter>::spill_runs(const char* inputFile, run_files& runs)
+{
+	// The input buffer and the output buffers of up to two spills in
+	// flight come out of the budget first. Two chunks share the rest,
+	// one being read and one being sorted and written. Half of each
+	// chunk's share is its array, half is what the elements own outside it
+	size_t chunkBytes = (memoryBudget - 3 * MIN_BUFFER_BYTES) / 2;
+	int chunkCapacity = std::clamp<size_t>(chunkBytes / 2 / sizeof(Type), 1, INT_MAX);
+	std::unique_ptr<ChunkSorter<Type>> chunks[2] = {
+		std::unique_ptr<ChunkSorter<Type>>(new ChunkSorter<Type>(chunkCapacity)),
+		std::unique_ptr<ChunkSorter<Type>>(new ChunkSorter<Type>(chunkCapacity))
+	};
+	std::future<void> spilling[2];
+
+	buffered_input input(inputFile, MIN_BUFFER_BYTES);
+
+	for(int chunk = 0; ; chunk = 1 - chunk)
+	{
+		// Wait for the last spill out of this chunk before reading into it
+		if(spilling[chunk].valid())
+		{
+			spilling[chunk].get();
+		}
+
+		if(chunks[chunk]->initialize_from_stream(input.in, chunkBytes / 2) == 0)
+		{
+			break;
+		}
+
+		// Sort and write this chunk while the next one is read
+		runs.names.push_back(new_run_name());
+		spilling[chunk] = std::async(std::launch::async, [&chunks, chunk, run = runs.names.back()]() {
+			chunks[chunk]->sort();
+
+			// One value per line, without flushing after each one
+			buffered_output output(run, MIN_BUFFER_BYTES);
+			const Type* sorted = chunks[chunk]->get_array();
+			for(int i = 0; i < chunks[chunk]->get_length(); i++)
+			{
+				output.out << sorted[i] << '\n';
+			}
+		});
+	}
+
+	// Finish the other chunk's spill too
+	for(std::future<void>& spill : spilling)
+	{
+		if(spill.valid())
+		{
+			spill.get();
+		}
+	}
+}
+
+template<typename Type, template<typename> class ChunkSorter>
+void external_sorter<Type, ChunkSorter>::merge_runs(const std::vector<std::string>& runs, const std::string& outputFile)
+{
+	// Share the budget between one buffer per run and the output buffer.
+	// There are never more than max_fan_in() runs, so each gets at least MIN_BUFFER_BYTES
+	size_t bufferBytes = memoryBudget / (runs.size() + 1);
+
+	std::vector<std::unique_ptr<buffered_input>> inputs;
+	loser_tree<Type> tree(runs.size());
+	for(int run = 0; run < (int)runs.size(); run++)
+	{
+		inputs.emplace_back(new buffered_input(runs[run], bufferBytes));
+		tree.set_head(run, inputs[run]->advance() ? &inputs[run]->head : nullptr);
+	}
+	tree.build();
+
+	buffered_output output(outputFile, bufferBytes);
+	while(!tree.empty())
+	{
+		int run = tree.winner();
+		output.out << tree.winner_head() << '\n';
+		tree.replace_winner(inputs[run]->advance() ? &inputs[run]->head : nullptr);
+	}
+}
+
+#endif /* EXTERNAL_SORTER_H_ */
@@ -6,6 +6,7 @@
 #define HEAP_SORTER_H_
 
 #include "sorter.h"
+#include "sort_order.h"
 
 template<typename Type>
 class heap_sorter : public sorter<Type>
@@ -19,6 +20,12 @@ public:
 
 	void sort_report();
 
+	std::string get_name() const { return "Heap Sort"; }
+
+	// Heap sort the given array of the given length in place
+	template<typename Order = default_order>
+	static void heap_sort(Type* array, int length, Order less = Order());
+
 protected:
 	// Reorganize the local array as a max heap
 	void max_heapify();
@@ -27,30 +34,41 @@ protected:
 	void max_heapify(int rootIndex);
 
 	// Max heapify a subsection of the local array rooted at root index
-	static void max_heapify(Type* array, int length, int rootIndex);
+	template<typename Order = default_order>
+	static void max_heapify(Type* array, int length, int rootIndex, Order less = Order());
 };
 
 template<typename Type>
 void heap_sorter<Type>::sort()
+{
+	heap_sort(this->array, this->arrayLen);
+}
+
+template<typename Type>
+template<typename Order>
+void heap_sorter<Type>::heap_sort(Type* array, int length, Order less)
 {
 	// Reorganize the entire array as a max heap
-	max_heapify();
+	for(int index = (length / 2) - 1; index >= 0; index--)
+	{
+		max_heapify(array, length, index, less);
+	}
 
-	for(int index = this->arrayLen - 1; index >= 0; index--)
+	for(int index = length - 1; index >= 0; index--)
 	{
 		// Put the root (biggest number) at the end
-		std::swap(this->array[0], this->array[index]);
+		std::swap(array[0], array[index]);
 
 		// Restore max heap properties of the unsorted
 		// portion of the array
-		max_heapify(this->array, index, 0);
+		max_heapify(array, index, 0, less);
 	}
 }
 
 template<typename Type>
 void heap_sorter<Type>::sort_report()
 {
-	sorter<Type>::sort_report("Heap Sort");
+	sorter<Type>::sort_report(get_name());
 }
 
 template<typename Type>
@@ -72,8 +90,11 @@ void heap_sorter<Type>::max_heapify(int rootIndex)
 }
 
 template<typename Type>
-void heap_sorter<Type>::max_heapify(Type* array, int length, int rootIndex)
+template<typename Order>
+void heap_sorter<Type>::max_heapify(Type* array, int length, int rootIndex, Order less)
 {
+	recursion_guard<Type> guard;
+
 	// Index of the largest element in the parent/children structure
 	int largest = rootIndex;
 
@@ -82,13 +103,13 @@ void heap_sorter<Type>::max_heapify(Type* array, int length, int rootIndex)
 	int rightChild = 2 * rootIndex + 2;
 
 	// If left child exists and is bigger than root, swap with the root
-	if(leftChild < length && array[largest] < array[leftChild])
+	if(leftChild < length && less(array[largest], array[leftChild]))
 	{
 		largest = leftChild;
 	}
 
 	// If right child exists and is bigger than the root, swap with the root
-	if(rightChild < length && array[largest] < array[rightChild])
+	if(rightChild < length && less(array[largest], array[rightChild]))
 	{
 		largest = rightChild;
 	}
@@ -97,7 +118,7 @@ void heap_sorter<Type>::max_heapify(Type* array, int length, int rootIndex)
 	if(largest != rootIndex)
 	{
 		std::swap(array[rootIndex], array[largest]);
-		max_heapify(array, length, largest);
+		max_heapify(array, length, largest, less);
 	}
 }
 
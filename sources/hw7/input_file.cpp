@@ -0,0 +1,75 @@
+/*
+ * input_file.cpp
+ */
+
+#include "input_file.h"
+#include <cctype>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+input_file::input_file(const char* filename) :
+	contents(nullptr), length(0)
+{
+	int fileDescriptor = open(filename, O_RDONLY);
+	if(fileDescriptor < 0)
+	{
+		throw invalid_argument(string("For input string ") + filename + ": could not open file with name");
+	}
+
+	struct stat fileStats;
+	if(fstat(fileDescriptor, &fileStats) == 0 && fileStats.st_size > 0)
+	{
+		length = fileStats.st_size;
+		void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+		if(mapping == MAP_FAILED)
+		{
+			close(fileDescriptor);
+			throw invalid_argument(string("For input string ") + filename + ": could not map file into memory");
+		}
+
+		// The file is read front to back exactly once
+		madvise(mapping, length, MADV_SEQUENTIAL);
+		contents = static_cast<const char*>(mapping);
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close(fileDescriptor);
+	tokenize();
+}
+
+input_file::~input_file()
+{
+	if(contents != nullptr)
+	{
+		munmap(const_cast<char*>(contents), length);
+	}
+}
+
+void input_file::tokenize()
+{
+	size_t index = 0;
+	while(index < length)
+	{
+		// Skip whitespace up to the start of the next token
+		while(index < length && isspace((unsigned char)contents[index]))
+		{
+			index++;
+		}
+
+		size_t start = index;
+		while(index < length && !isspace((unsigned char)contents[index]))
+		{
+			index++;
+		}
+
+		if(index > start)
+		{
+			tokens.emplace_back(contents + start, index - start);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+/*
+ * input_file.h
+ *
+ * Maps an input file into memory once and splits it into whitespace
+ * separated tokens that point straight into the mapping, so the file
+ * is read and parsed once no matter how many sorters load from it
+ */
+
+#ifndef INPUT_FILE_H_
+#define INPUT_FILE_H_
+
+#include <charconv>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class input_file
+{
+// PRIVATE DATA
+private:
+	// Start and length of the mapped file contents
+	const char* contents;
+	size_t length;
+	// Tokens of the file in order, each pointing into the contents
+	std::vector<std::string_view> tokens;
+
+// PUBLIC INTERFACE
+public:
+	// Map the file with the given name and split it into tokens
+	input_file(const char* filename);
+
+	input_file(const input_file&) = delete;
+	input_file& operator=(const input_file&) = delete;
+
+	// Number of tokens in the file
+	int size() const { return tokens.size(); }
+
+	// Tokens of the file, valid as long as this object is
+	const std::vector<std::string_view>& get_tokens() const { return tokens; }
+
+	// Parse the first maxCount tokens (all of them if negative) into values,
+	// the same way reading them one by one with operator>> would
+	template<typename Type>
+	std::vector<Type> parse(int maxCount = -1) const;
+
+	// Unmap the file
+	~input_file();
+
+// PRIVATE UTILITIES
+private:
+	// Split the contents on whitespace
+	void tokenize();
+
+	// Convert a single token into a value
+	template<typename Type>
+	static Type parse_token(std::string_view token);
+};
+
+template<typename Type>
+std::vector<Type> input_file::parse(int maxCount) const
+{
+	int count = maxCount < 0 || maxCount > size() ? size() : maxCount;
+
+	std::vector<Type> values;
+	values.reserve(count);
+	for(int i = 0; i < count; i++)
+	{
+		values.push_back(parse_token<Type>(tokens[i]));
+	}
+	return values;
+}
+
+template<typename Type>
+Type input_file::parse_token(std::string_view token)
+{
+	if constexpr(std::is_same<Type, std::string>::value)
+	{
+		return Type(token);
+	}
+	else if constexpr(std::is_arithmetic<Type>::value)
+	{
+		Type value = Type();
+		std::from_chars(token.data(), token.data() + token.size(), value);
+		return value;
+	}
+	else
+	{
+		// Anything else parses the way the sorters always read it
+		Type value;
+		std::istringstream in{std::string(token)};
+		in >> value;
+		return value;
+	}
+}
+
+#endif /* INPUT_FILE_H_ */
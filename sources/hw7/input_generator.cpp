@@ -0,0 +1,56 @@
+/*
+ * input_generator.cpp
+ */
+
+#include "input_generator.h"
+using namespace std;
+
+const char* input_generator::name(distribution shape)
+{
+	static const char* NAMES[TOTAL_DISTRIBUTIONS] = {
+		"uniform", "sorted", "reverse", "organ-pipe", "few-unique", "zipf", "sawtooth", "shared-prefix"
+	};
+	return shape >= 0 && shape < TOTAL_DISTRIBUTIONS ? NAMES[shape] : "unknown";
+}
+
+uint64_t input_generator::random_bits(size_t index) const
+{
+	uint64_t bits = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+	bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+	return bits ^ (bits >> 31);
+}
+
+uint64_t input_generator::key(distribution shape, size_t index, size_t count) const
+{
+	// Keys stay below 10^12 so they fit the digits of a generated string
+	const uint64_t KEY_RANGE = 1000000000000ULL;
+
+	switch(shape)
+	{
+	case SORTED:
+		return index;
+	case REVERSE:
+		return count - 1 - index;
+	case ORGAN_PIPE:
+		return index < count / 2 ? index : count - 1 - index;
+	case FEW_UNIQUE:
+		return random_bits(index) % FEW_UNIQUE_VALUES;
+	case ZIPF:
+	{
+		// Inverse of the continuous approximation of the Zipf CDF over keys [1, count]
+		double uniform = (random_bits(index) >> 11) * (1.0 / (1ULL << 53));
+		uint64_t rank = (uint64_t)pow((double)count + 1, uniform);
+		return std::max<uint64_t>(1, std::min<uint64_t>(rank, count));
+	}
+	case SAWTOOTH:
+	{
+		size_t toothLength = std::max<size_t>(1, (count + SAWTOOTH_TEETH - 1) / SAWTOOTH_TEETH);
+		return index % toothLength;
+	}
+	case UNIFORM:
+	case SHARED_PREFIX:
+	default:
+		return random_bits(index) % KEY_RANGE;
+	}
+}
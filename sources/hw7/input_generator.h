@@ -0,0 +1,140 @@
+/*
+ * input_generator.h
+ *
+ * Seeded synthetic inputs for the sort benchmarks. Every element is a
+ * function of the seed and its own index only, so the output is the
+ * same no matter how many threads generate it, and any size can be
+ * generated in parallel chunks
+ */
+
+#ifndef INPUT_GENERATOR_H_
+#define INPUT_GENERATOR_H_
+
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class input_generator
+{
+// PUBLIC TYPEDEFS
+public:
+	enum distribution
+	{
+		UNIFORM,	// Independent random keys
+		SORTED,	// Ascending keys
+		REVERSE,	// Descending keys
+		ORGAN_PIPE,	// Ascending to the middle, then descending
+		FEW_UNIQUE,	// Random keys out of only a handful of values
+		ZIPF,	// Random keys where key k comes up about 1/k as often as key 1
+		SAWTOOTH,	// Several ascending runs one after the other
+		SHARED_PREFIX,	// Random keys; strings start with the same long prefix
+		TOTAL_DISTRIBUTIONS
+	};
+
+// PRIVATE DATA
+private:
+	// Values the few-unique distribution picks from
+	static const int FEW_UNIQUE_VALUES = 16;
+	// Ascending runs in the sawtooth distribution
+	static const int SAWTOOTH_TEETH = 16;
+	// Length of the prefix shared by every shared-prefix string
+	static const int SHARED_PREFIX_LENGTH = 48;
+	// Digits every generated string has, zero padded so strings sort like their keys
+	static const int STRING_DIGITS = 12;
+	// Elements each parallel task generates
+	static const int CHUNK_SIZE = 1 << 16;
+
+	std::uint64_t seed;
+	int threadCount;
+
+// PUBLIC INTERFACE
+public:
+	input_generator(std::uint64_t seed, int threadCount = 1) :
+		seed(seed), threadCount(std::max(1, threadCount)) {}
+
+	// Generate count elements of the given distribution. Numbers are the
+	// keys themselves, strings are the keys written as zero padded decimals
+	template<typename Type>
+	std::vector<Type> generate(distribution shape, std::size_t count) const;
+
+	// Name of the distribution for reports
+	static const char* name(distribution shape);
+
+// PRIVATE UTILITIES
+private:
+	// Key of the element at the given index
+	std::uint64_t key(distribution shape, std::size_t index, std::size_t count) const;
+
+	// Random bits for the element at the given index (splitmix64 of the seed and index)
+	std::uint64_t random_bits(std::size_t index) const;
+
+	// Turn a key into an element
+	template<typename Type>
+	static Type make_element(distribution shape, std::uint64_t key);
+};
+
+template<typename Type>
+std::vector<Type> input_generator::generate(distribution shape, std::size_t count) const
+{
+	std::vector<Type> elements(count);
+	int chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+	auto generateChunk = [this, shape, count, &elements](int chunk) {
+		std::size_t end = std::min(count, (std::size_t)(chunk + 1) * CHUNK_SIZE);
+		for(std::size_t i = (std::size_t)chunk * CHUNK_SIZE; i < end; i++)
+		{
+			elements[i] = make_element<Type>(shape, key(shape, i, count));
+		}
+	};
+
+	if(threadCount > 1 && chunks > 1)
+	{
+		work_stealing_pool pool(threadCount);
+		pool.parallel_for(chunks, generateChunk);
+	}
+	else
+	{
+		for(int chunk = 0; chunk < chunks; chunk++)
+		{
+			generateChunk(chunk);
+		}
+	}
+
+	return elements;
+}
+
+template<typename Type>
+Type input_generator::make_element(distribution shape, std::uint64_t key)
+{
+	if constexpr(std::is_same<Type, std::string>::value)
+	{
+		std::string digits = std::to_string(key);
+		std::string element;
+		element.reserve((shape == SHARED_PREFIX ? SHARED_PREFIX_LENGTH : 0) + STRING_DIGITS);
+		if(shape == SHARED_PREFIX)
+		{
+			element.append(SHARED_PREFIX_LENGTH, 'a');
+		}
+		element.append(std::max(0, STRING_DIGITS - (int)digits.size()), '0');
+		element += digits;
+		return element;
+	}
+	else if constexpr(std::is_integral<Type>::value)
+	{
+		// Keys go up to 10^12, so reduce them into the non-negative range of
+		// narrow types instead of letting the cast wrap them around
+		const std::uint64_t typeRange = (std::uint64_t)std::numeric_limits<Type>::max() + 1;
+		return static_cast<Type>(typeRange == 0 ? key : key % typeRange);
+	}
+	else
+	{
+		return static_cast<Type>(key);
+	}
+}
+
+#endif /* INPUT_GENERATOR_H_ */
@@ -6,6 +6,8 @@
 #define INSERTION_SORTER_H_
 
 #include "sorter.h"
+#include "sort_kernels.h"
+#include "sort_order.h"
 
 // INTERFACE
 
@@ -20,6 +22,15 @@ public:
 
 	void sort_report();
 
+	std::string get_name() const { return "Insertion Sort"; }
+
+	// Insertion sort the part [start, end) of the given array in place
+	template<typename Order = default_order>
+	static void insertion_sort(Type* array, int start, int end, Order less = Order())
+	{
+		sort_kernels<Type>::insertion_sort(array, start, end, less);
+	}
+
 private:
 	// Insert the value given in the array in the part [0, end] (inclusive)
 	void ordered_insert(int end, Type value);
@@ -53,7 +64,7 @@ void insertion_sorter<Type>::ordered_insert(int end, Type value)
 template<typename Type>
 void insertion_sorter<Type>::sort_report()
 {
-	sorter<Type>::sort_report("Insertion Sort");
+	sorter<Type>::sort_report(get_name());
 }
 
 #endif /* INSERTION_SORTER_H_ */
@@ -0,0 +1,104 @@
+/*
+ * INTRO SORTER: Time complexity - O(nlogn) worst case
+ *
+ * Quicksort with a median-of-three (ninther for big ranges) pivot, an
+ * insertion sort for small ranges, and a heap sort fallback once the
+ * recursion gets deeper than 2log(n)
+ */
+
+#ifndef INTRO_SORTER_H_
+#define INTRO_SORTER_H_
+
+#include "sorter.h"
+#include "heap_sorter.h"
+#include "sort_kernels.h"
+#include "sort_order.h"
+#include <algorithm>
+
+// INTERFACE
+
+template<typename Type>
+class intro_sorter : public sorter<Type>
+{
+public:
+	intro_sorter(int capacity) :
+		sorter<Type>(capacity) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return "Intro Sort"; }
+
+	// Introsort the part [start, end) of the given array in place
+	template<typename Order = default_order>
+	static void intro_sort(Type* array, int start, int end, Order less = Order());
+
+private:
+	// Ranges this small or smaller are insertion sorted
+	static const int INSERTION_CUTOFF = 16;
+
+	// Sort the range [start, end), falling back to heap sort
+	// once the depth budget runs out
+	template<typename Order>
+	static void sort_recursive(Type* array, int start, int end, int depthBudget, Order less);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void intro_sorter<Type>::sort()
+{
+	intro_sort(this->array, 0, this->arrayLen);
+}
+
+template<typename Type>
+void intro_sorter<Type>::sort_report()
+{
+	sorter<Type>::sort_report(get_name());
+}
+
+template<typename Type>
+template<typename Order>
+void intro_sorter<Type>::intro_sort(Type* array, int start, int end, Order less)
+{
+	sort_recursive(array, start, end, sort_kernels<Type>::depth_budget(end - start), less);
+}
+
+template<typename Type>
+template<typename Order>
+void intro_sorter<Type>::sort_recursive(Type* array, int start, int end, int depthBudget, Order less)
+{
+	recursion_guard<Type> guard;
+
+	while(end - start > INSERTION_CUTOFF)
+	{
+		// Partitioning is going badly, so heap sort what is left
+		if(depthBudget == 0)
+		{
+			heap_sorter<Type>::heap_sort(array + start, end - start, less);
+			return;
+		}
+		depthBudget--;
+
+		int pivot = sort_kernels<Type>::partition(array, start, end,
+				sort_kernels<Type>::choose_pivot(array, start, end, less), less);
+
+		// Recurse into the smaller side and loop on the bigger side
+		// so the stack never goes deeper than log(n)
+		if(pivot - start < end - pivot)
+		{
+			sort_recursive(array, start, pivot, depthBudget, less);
+			start = pivot + 1;
+		}
+		else
+		{
+			sort_recursive(array, pivot + 1, end, depthBudget, less);
+			end = pivot;
+		}
+	}
+
+	sort_kernels<Type>::insertion_sort(array, start, end, less);
+}
+
+#endif /* INTRO_SORTER_H_ */
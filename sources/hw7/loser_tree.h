@@ -0,0 +1,131 @@
+/*
+ * loser_tree.h
+ *
+ * Tournament tree for k-way merging. Each internal node remembers the loser
+ * of the match played there, so replacing the winner only replays the
+ * log(k) matches on its path to the root. Ties go to the source with the
+ * lower index, which keeps merges stable
+ */
+
+#ifndef LOSER_TREE_H_
+#define LOSER_TREE_H_
+
+#include <utility>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class loser_tree
+{
+private:
+	// Number of sources being merged
+	int sourceCount;
+	// tree[0] is the overall winner, tree[1..k-1] the loser at each internal node
+	std::vector<int> tree;
+	// Current element at the front of each source, nullptr once it runs out
+	std::vector<const Type*> heads;
+
+public:
+	loser_tree(int sourceCount) :
+		sourceCount(sourceCount), tree(sourceCount > 1 ? sourceCount : 1, 0),
+		heads(sourceCount, nullptr) {}
+
+	// Set the front element of a source, call build() after setting all of them
+	void set_head(int source, const Type* head) { heads[source] = head; }
+
+	// Play all the matches to find the first winner
+	void build();
+
+	// True once every source has run out
+	bool empty() const { return sourceCount == 0 || heads[tree[0]] == nullptr; }
+
+	// Index of the source with the smallest front element
+	int winner() const { return tree[0]; }
+
+	// Smallest front element across all sources
+	const Type& winner_head() const { return *heads[tree[0]]; }
+
+	// Advance the winning source to its next element (nullptr if it ran out)
+	// and replay its path to find the next winner
+	void replace_winner(const Type* nextHead);
+
+private:
+	// Return true if the front of source a comes before the front of source b
+	bool beats(int a, int b) const;
+
+	// Play the matches under the given node and return the winner
+	int build_recursive(int node);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void loser_tree<Type>::build()
+{
+	if(sourceCount > 0)
+	{
+		tree[0] = build_recursive(1);
+	}
+}
+
+template<typename Type>
+void loser_tree<Type>::replace_winner(const Type* nextHead)
+{
+	int winner = tree[0];
+	heads[winner] = nextHead;
+
+	// Leaves live at nodes [k, 2k), so walk up from the winner's leaf
+	for(int node = (winner + sourceCount) / 2; node > 0; node /= 2)
+	{
+		if(beats(tree[node], winner))
+		{
+			std::swap(tree[node], winner);
+		}
+	}
+	tree[0] = winner;
+}
+
+template<typename Type>
+bool loser_tree<Type>::beats(int a, int b) const
+{
+	const Type* headA = heads[a];
+	const Type* headB = heads[b];
+
+	// Exhausted sources lose to everything
+	if(headA == nullptr || headB == nullptr)
+	{
+		return headB == nullptr && (headA != nullptr || a < b);
+	}
+	if(*headA < *headB)
+	{
+		return true;
+	}
+	if(*headB < *headA)
+	{
+		return false;
+	}
+	return a < b;
+}
+
+template<typename Type>
+int loser_tree<Type>::build_recursive(int node)
+{
+	if(node >= sourceCount)
+	{
+		return node - sourceCount;
+	}
+
+	int left = build_recursive(2 * node);
+	int right = build_recursive(2 * node + 1);
+
+	// Keep the loser here and pass the winner up
+	if(beats(right, left))
+	{
+		std::swap(left, right);
+	}
+	tree[node] = right;
+	return left;
+}
+
+#endif /* LOSER_TREE_H_ */
@@ -9,12 +9,47 @@
 #include "insertion_sorter.h"
 #include "quick_sorter.h"
 #include "heap_sorter.h"
+#include "dary_heap_sorter.h"
+#include "intro_sorter.h"
+#include "merge_sorter.h"
+#include "run_sorter.h"
+#include "sample_sorter.h"
+#include "sorted_log.h"
+#include "string_radix_sorter.h"
+#include "collation_sorter.h"
+#include "prefix_key_sorter.h"
+#include "input_file.h"
+#include "input_generator.h"
+#include "sort_benchmark.h"
+#include "external_sorter.h"
+#include <fstream>
 #include <vector>
+#include <thread>
 using namespace std;
 
 const int TOTAL_STRINGS = 45000;	// Total strings in sample input file
 const int TOTAL_PARTITIONS = 10;	// Total times the input files are partitioned
 
+// Threads used by the parallel sorters
+const int TOTAL_THREADS = std::max(1u, std::thread::hardware_concurrency());
+
+const int TOTAL_WARMUPS = 1;	// Untimed sorts before each benchmark
+const int TOTAL_REPETITIONS = 5;	// Timed sorts each benchmark is summarized over
+
+// Files the benchmark results are written to
+const char* CSV_OUTPUT_FILE = "benchmark.csv";
+const char* JSON_OUTPUT_FILE = "benchmark.json";
+
+// Strings in each generated input and the seed they are generated from
+const int GENERATED_STRINGS = 10000;
+const unsigned long long GENERATOR_SEED = 20190421;
+
+// Smallest strings of each file found without sorting it
+const int TOTAL_SMALLEST = 5;
+
+// Memory the external sort may use, well under the size of the input files
+const size_t EXTERNAL_MEMORY_BUDGET = 256 * 1024;
+
 const int TOTAL_INPUT_FILES = 2;
 const string* INPUT_FILES = new string[TOTAL_INPUT_FILES]{
 	"random.txt",
@@ -23,16 +58,45 @@ const string* INPUT_FILES = new string[TOTAL_INPUT_FILES]{
 
 int main()
 {
+	// Parallel sorts whose reports also compare against a serial run or time each phase
+	quick_sorter<string>* parallelQuickSorter = new quick_sorter<string>(TOTAL_STRINGS, TOTAL_THREADS);
+	sample_sorter<string>* sampleSorter = new sample_sorter<string>(TOTAL_STRINGS, TOTAL_THREADS);
+	vector<sorter<string>*> parallelSorters = { parallelQuickSorter, sampleSorter };
+
 	// List of sorting classes
 	vector<sorter<string>*> sorters = {
 		new insertion_sorter<string>(TOTAL_STRINGS),
 		new quick_sorter<string>(TOTAL_STRINGS),
-		new heap_sorter<string>(TOTAL_STRINGS)
+		parallelQuickSorter,
+		new heap_sorter<string>(TOTAL_STRINGS),
+		new dary_heap_sorter<string, 4>(TOTAL_STRINGS),
+		new dary_heap_sorter<string, 8>(TOTAL_STRINGS),
+		new intro_sorter<string>(TOTAL_STRINGS),
+		new merge_sorter<string>(TOTAL_STRINGS, TOTAL_THREADS),
+		new run_sorter<string>(TOTAL_STRINGS),
+		sampleSorter,
+		new string_radix_sorter(TOTAL_STRINGS),
+		new collation_sorter(TOTAL_STRINGS),
+		new prefix_key_sorter<quick_sorter>(TOTAL_STRINGS, "Prefix Key Quick Sort"),
+		new prefix_key_sorter<heap_sorter>(TOTAL_STRINGS, "Prefix Key Heap Sort")
 	};
-	// Function object calls "sort and report" on the given sorter
-	auto sortAndReport = [](sorter<string>*& sorter) {
-		sorter->sort_report();
+	// Quick sort that groups the keys equal to the pivot, next to the other quick sorts
+	quick_sorter<string>* threeWayQuickSorter = new quick_sorter<string>(TOTAL_STRINGS);
+	threeWayQuickSorter->set_three_way(true);
+	sorters.insert(sorters.begin() + 3, threeWayQuickSorter);
+
+	// Comparison sorts that count their operations on the whole file
+	vector<sorter<counted<string>>*> countedSorters = {
+		new quick_sorter<counted<string>>(TOTAL_STRINGS),
+		new heap_sorter<counted<string>>(TOTAL_STRINGS),
+		new dary_heap_sorter<counted<string>, 4>(TOTAL_STRINGS),
+		new dary_heap_sorter<counted<string>, 8>(TOTAL_STRINGS),
+		new intro_sorter<counted<string>>(TOTAL_STRINGS),
+		new merge_sorter<counted<string>>(TOTAL_STRINGS, TOTAL_THREADS),
+		new run_sorter<counted<string>>(TOTAL_STRINGS)
 	};
+	// Benchmark that times every sorter on every partition
+	sort_benchmark benchmark(TOTAL_WARMUPS, TOTAL_REPETITIONS);
 	// Function object deletes a pointer to a sorter
 	auto deleteSorter = [](sorter<string>*& sorter) {
 		delete sorter;
@@ -43,25 +107,126 @@ int main()
 		// Output the file name being sorted
 		cout << "--- SORTING FILE NAME \"" << INPUT_FILES[file] << "\" ---" << endl;
 
+		// Read and parse the file once, every partition copies a prefix of it
+		input_file input(INPUT_FILES[file].c_str());
+		vector<string> strings = input.parse<string>(TOTAL_STRINGS);
+
 		for(int partition = 1; partition <= TOTAL_PARTITIONS; partition++)
 		{
-			// Initialize each of the sorters from the same file
-			auto initializeFromFile = [partition, file](sorter<string>*& sorter) {
-				sorter->initialize_from_file(INPUT_FILES[file].c_str(), TOTAL_STRINGS * ((float)partition / TOTAL_PARTITIONS));
-			};
-			for_each(sorters.begin(), sorters.end(), initializeFromFile);
+			int numToLoad = min<int>(TOTAL_STRINGS * ((float)partition / TOTAL_PARTITIONS), strings.size());
 
 			// Output the number of strings being sorted in this partition
-			cout << "--- SORTING " << TOTAL_STRINGS * ((float)partition / TOTAL_PARTITIONS) << " STRINGS ---" << endl << endl;
+			cout << "--- SORTING " << numToLoad << " STRINGS ---" << endl << endl;
 
-			// Sort and report on each of the sorters
-			for_each(sorters.begin(), sorters.end(), sortAndReport);
+			// Benchmark each of the sorters on fresh copies of the same data
+			auto benchmarkSorter = [&](sorter<string>*& sorter) {
+				sort_benchmark::print_report(cout,
+						benchmark.run(*sorter, INPUT_FILES[file], strings.data(), numToLoad));
+			};
+			for_each(sorters.begin(), sorters.end(), benchmarkSorter);
 			cout << endl;
 		}
+
+		// Report the operation counts of the comparison sorts on the whole file
+		vector<counted<string>> countedStrings(strings.begin(), strings.end());
+		cout << "--- COUNTING OPERATIONS ON " << countedStrings.size() << " STRINGS ---" << endl << endl;
+		for(sorter<counted<string>>* countedSorter : countedSorters)
+		{
+			countedSorter->initialize_from_data(countedStrings.data(), countedStrings.size());
+			countedSorter->sort_report();
+		}
+		cout << endl;
+
+		// Report the speedup and phase times of the parallel sorts on the whole file
+		cout << "--- PARALLEL SORTS ON " << strings.size() << " STRINGS ---" << endl << endl;
+		for(sorter<string>* parallelSorter : parallelSorters)
+		{
+			parallelSorter->initialize_from_data(strings.data(), strings.size());
+			parallelSorter->sort_report();
+		}
+		cout << endl;
+
+		// Find the median and the smallest strings without sorting the file
+		cout << "--- SELECTING FROM " << strings.size() << " STRINGS ---" << endl << endl;
+		sorters.front()->initialize_from_data(strings.data(), strings.size());
+		cout << "Median string: " << sorters.front()->select(strings.size() / 2) << endl;
+
+		ifstream smallestIn(INPUT_FILES[file]);
+		cout << "Smallest " << TOTAL_SMALLEST << " strings:";
+		for(const string& smallest : sorter<string>::top_k(smallestIn, TOTAL_SMALLEST))
+		{
+			cout << " " << smallest;
+		}
+		cout << endl;
+
+		// Count every distinct string while sorting
+		sorters.front()->initialize_from_data(strings.data(), strings.size());
+		vector<pair<string, int>> stringCounts = sorters.front()->sort_count();
+		auto mostCommon = max_element(stringCounts.begin(), stringCounts.end(),
+				[](const pair<string, int>& a, const pair<string, int>& b) { return a.second < b.second; });
+		cout << "Distinct strings: " << stringCounts.size();
+		if(mostCommon != stringCounts.end())
+		{
+			cout << ", most common: " << mostCommon->first << " (" << mostCommon->second << " times)";
+		}
+		cout << endl << endl;
+
+		// Keep the strings sorted while they come in one at a time
+		sorted_log<string> incremental;
+		auto incrementalBegin = chrono::steady_clock::now();
+		for(const string& str : strings)
+		{
+			incremental.insert(str);
+		}
+		auto incrementalTime = chrono::steady_clock::now() - incrementalBegin;
+
+		cout << setfill('-') << left << setw(23) << "Incremental Sort:" << ">: inserted in "
+			<< fixed << setprecision(3) << chrono::duration<double, milli>(incrementalTime).count()
+			<< " milliseconds (" << incremental.level_count() << " levels)" << endl << endl;
+		cout << setfill(' ') << right << defaultfloat;
+
+		// Sort the whole file again without ever holding all of it in memory
+		cout << "--- EXTERNAL SORT WITH " << EXTERNAL_MEMORY_BUDGET / 1024 << " KB OF MEMORY ---" << endl << endl;
+		external_sorter<string> externalSorter(EXTERNAL_MEMORY_BUDGET);
+		auto externalBegin = chrono::steady_clock::now();
+		externalSorter.sort_file(INPUT_FILES[file].c_str(), ("sorted_" + INPUT_FILES[file]).c_str());
+		auto externalTime = chrono::steady_clock::now() - externalBegin;
+
+		cout << setfill('-') << left << setw(23) << "External Sort:" << ">: completed in "
+			<< fixed << setprecision(3) << chrono::duration<double, milli>(externalTime).count()
+			<< " milliseconds (" << externalSorter.get_run_count() << " runs)" << endl << endl;
+		cout << setfill(' ') << right << defaultfloat;
 	}
 
+	// Benchmark on generated inputs that expose the worst cases of the sorters
+	input_generator generator(GENERATOR_SEED, TOTAL_THREADS);
+	for(int shape = 0; shape < input_generator::TOTAL_DISTRIBUTIONS; shape++)
+	{
+		auto distribution = (input_generator::distribution)shape;
+		vector<string> strings = generator.generate<string>(distribution, GENERATED_STRINGS);
+		string inputName = string("generated ") + input_generator::name(distribution);
+
+		cout << "--- SORTING " << GENERATED_STRINGS << " GENERATED " << input_generator::name(distribution)
+			<< " STRINGS ---" << endl << endl;
+		for(sorter<string>* sorter : sorters)
+		{
+			sort_benchmark::print_report(cout, benchmark.run(*sorter, inputName, strings.data(), strings.size()));
+		}
+		cout << endl;
+	}
+
+	// Write the results out so they can be compared between runs
+	ofstream csvOut(CSV_OUTPUT_FILE);
+	benchmark.write_csv(csvOut);
+	ofstream jsonOut(JSON_OUTPUT_FILE);
+	benchmark.write_json(jsonOut);
+
 	// Delete each of the sorters before exiting
 	for_each(sorters.begin(), sorters.end(), deleteSorter);
+	for(sorter<counted<string>>* countedSorter : countedSorters)
+	{
+		delete countedSorter;
+	}
 
 	return 0;
 }
@@ -0,0 +1,265 @@
+/*
+ * MERGE SORTER: Time complexity - O(nlogn), stable
+ *
+ * Each thread sorts its own slice of the array into a sorted run, then
+ * each thread merges its share of the output from all runs at once with
+ * a loser tree. Equal elements keep their original order
+ */
+
+#ifndef MERGE_SORTER_H_
+#define MERGE_SORTER_H_
+
+#include "sorter.h"
+#include "insertion_sorter.h"
+#include "loser_tree.h"
+#include "work_stealing_pool.h"
+#include "sorting_network.h"
+#include "sort_order.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class merge_sorter : public sorter<Type>
+{
+public:
+	// Threads above 1 sort one run per thread and merge them in parallel
+	merge_sorter(int capacity, int threadCount = 1) :
+		sorter<Type>(capacity), threadCount(threadCount) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return threadCount > 1 ? "Parallel Merge Sort" : "Merge Sort"; }
+
+	void set_thread_count(int threads) { threadCount = threads; }
+
+	// Stable merge sort the part [start, end) of the given array, using
+	// the same part of the scratch array as temporary storage
+	template<typename Order = default_order>
+	static void merge_sort(Type* array, Type* scratch, int start, int end, Order less = Order());
+
+private:
+	// Ranges this small or smaller are insertion sorted
+	static const int INSERTION_CUTOFF = 16;
+	// Fewest elements worth giving a thread its own run
+	static const int MIN_RUN_PER_THREAD = 4096;
+
+	// Number of threads used to sort, 1 sorts on the calling thread
+	int threadCount;
+	// Merge output buffer, kept between sorts so it is only allocated once
+	std::vector<Type> scratch;
+	// Workers for the parallel sort, started on the first parallel sort
+	std::unique_ptr<work_stealing_pool> pool;
+
+	bool sorts_in_parallel() const { return std::min(threadCount, this->arrayLen / MIN_RUN_PER_THREAD) > 1; }
+
+	// Run the task once per index in [0, count) on the pool and wait for all of them
+	template<typename Task>
+	void parallel_for(int count, Task task);
+
+	// Return the position in each run such that the elements before those
+	// positions are exactly the first (rank) elements of the merged output
+	std::vector<int> split_at_rank(const std::vector<int>& runBounds, int rank) const;
+
+	// Return the position the element at the given index of the given run
+	// takes in the merged output of all runs
+	int merged_rank(const std::vector<int>& runBounds, int run, int index) const;
+
+	// Merge the parts [from[run], to[run]) of every run into scratch starting at out
+	void multiway_merge(const std::vector<int>& runBounds, const std::vector<int>& from,
+			const std::vector<int>& to, int out);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void merge_sorter<Type>::sort()
+{
+	int length = this->arrayLen;
+	if(length < 2)
+	{
+		return;
+	}
+
+	scratch.resize(length);
+
+	// Don't start more runs than there is work for
+	int runs = std::max(1, std::min(threadCount, length / MIN_RUN_PER_THREAD));
+	if(runs == 1)
+	{
+		merge_sort(this->array, scratch.data(), 0, length);
+		return;
+	}
+
+	// Split the array into one slice per thread and sort each into a run
+	std::vector<int> runBounds(runs + 1);
+	for(int run = 0; run <= runs; run++)
+	{
+		runBounds[run] = (long long)length * run / runs;
+	}
+	parallel_for(runs, [this, &runBounds](int run) {
+		merge_sort(this->array, scratch.data(), runBounds[run], runBounds[run + 1]);
+	});
+
+	// Give each thread an equal share of the output and find where
+	// that share starts in every run
+	std::vector<std::vector<int>> splits(runs + 1);
+	for(int part = 0; part <= runs; part++)
+	{
+		splits[part] = split_at_rank(runBounds, runBounds[part]);
+	}
+	parallel_for(runs, [this, &runBounds, &splits](int part) {
+		multiway_merge(runBounds, splits[part], splits[part + 1], runBounds[part]);
+	});
+
+	// Move the merged output back into the array
+	parallel_for(runs, [this, &runBounds](int part) {
+		std::move(scratch.begin() + runBounds[part], scratch.begin() + runBounds[part + 1],
+				this->array + runBounds[part]);
+	});
+}
+
+template<typename Type>
+void merge_sorter<Type>::sort_report()
+{
+	sorter<Type>::sort_report(get_name());
+}
+
+template<typename Type>
+template<typename Order>
+void merge_sorter<Type>::merge_sort(Type* array, Type* scratch, int start, int end, Order less)
+{
+	recursion_guard<Type> guard;
+
+	// Small ranges of numbers in ascending order go through a sorting network
+	// instead. It isn't stable, but equal numbers can't be told apart anyway
+	if constexpr(sorting_network::supports<Type>::value && std::is_same<Order, default_order>::value)
+	{
+		if(end - start <= sorting_network::MAX_BLOCK)
+		{
+			sorting_network::sort(array + start, end - start);
+			return;
+		}
+	}
+
+	if(end - start <= INSERTION_CUTOFF)
+	{
+		insertion_sorter<Type>::insertion_sort(array, start, end, less);
+		return;
+	}
+
+	int middle = start + (end - start) / 2;
+	merge_sort(array, scratch, start, middle, less);
+	merge_sort(array, scratch, middle, end, less);
+
+	// The halves are already in order, which is common on presorted input
+	if(!less(array[middle], array[middle - 1]))
+	{
+		return;
+	}
+
+	// std::merge takes from the first half on ties, so the sort stays stable
+	std::merge(std::make_move_iterator(array + start), std::make_move_iterator(array + middle),
+			std::make_move_iterator(array + middle), std::make_move_iterator(array + end),
+			scratch + start, less);
+	std::move(scratch + start, scratch + end, array + start);
+}
+
+template<typename Type>
+template<typename Task>
+void merge_sorter<Type>::parallel_for(int count, Task task)
+{
+	// (Re)start the pool if the thread count changed
+	if(!pool || pool->thread_count() != threadCount)
+	{
+		pool.reset(new work_stealing_pool(threadCount));
+	}
+
+	pool->parallel_for(count, task);
+}
+
+template<typename Type>
+std::vector<int> merge_sorter<Type>::split_at_rank(const std::vector<int>& runBounds, int rank) const
+{
+	int runs = runBounds.size() - 1;
+	std::vector<int> split(runs);
+
+	for(int run = 0; run < runs; run++)
+	{
+		// Ranks only go up along a run, so binary search for the
+		// number of elements in this run that rank below the target
+		int low = runBounds[run];
+		int high = runBounds[run + 1];
+		while(low < high)
+		{
+			int middle = low + (high - low) / 2;
+			if(merged_rank(runBounds, run, middle) < rank)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		split[run] = low;
+	}
+	return split;
+}
+
+template<typename Type>
+int merge_sorter<Type>::merged_rank(const std::vector<int>& runBounds, int run, int index) const
+{
+	const Type& value = this->array[index];
+	int rank = index - runBounds[run];
+	int runs = runBounds.size() - 1;
+
+	// Equal elements of earlier runs come first, equal elements of later runs come after
+	for(int other = 0; other < runs; other++)
+	{
+		const Type* begin = this->array + runBounds[other];
+		const Type* end = this->array + runBounds[other + 1];
+
+		if(other < run)
+		{
+			rank += std::upper_bound(begin, end, value) - begin;
+		}
+		else if(other > run)
+		{
+			rank += std::lower_bound(begin, end, value) - begin;
+		}
+	}
+	return rank;
+}
+
+template<typename Type>
+void merge_sorter<Type>::multiway_merge(const std::vector<int>& runBounds,
+		const std::vector<int>& from, const std::vector<int>& to, int out)
+{
+	int runs = runBounds.size() - 1;
+	std::vector<int> position(from);
+	loser_tree<Type> tree(runs);
+
+	for(int run = 0; run < runs; run++)
+	{
+		tree.set_head(run, position[run] < to[run] ? this->array + position[run] : nullptr);
+	}
+	tree.build();
+
+	while(!tree.empty())
+	{
+		int run = tree.winner();
+		scratch[out++] = std::move(this->array[position[run]]);
+
+		position[run]++;
+		tree.replace_winner(position[run] < to[run] ? this->array + position[run] : nullptr);
+	}
+}
+
+#endif /* MERGE_SORTER_H_ */
@@ -0,0 +1,103 @@
+/*
+ * perf_counters.cpp
+ */
+
+#include "perf_counters.h"
+#include <sstream>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+#ifdef __linux__
+// Open one counter of the calling thread on any cpu, disabled to start with
+static int open_counter(unsigned long long config)
+{
+	perf_event_attr attributes = {};
+	attributes.size = sizeof(attributes);
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.config = config;
+	attributes.disabled = 1;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+
+	return syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+#endif
+
+perf_counters::perf_counters()
+{
+	for(int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		descriptors[i] = -1;
+		values[i] = 0;
+	}
+
+#ifdef __linux__
+	descriptors[CYCLES] = open_counter(PERF_COUNT_HW_CPU_CYCLES);
+	descriptors[BRANCH_MISSES] = open_counter(PERF_COUNT_HW_BRANCH_MISSES);
+	descriptors[CACHE_MISSES] = open_counter(PERF_COUNT_HW_CACHE_MISSES);
+#endif
+}
+
+perf_counters::~perf_counters()
+{
+#ifdef __linux__
+	for(int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		if(available((counter)i))
+		{
+			close(descriptors[i]);
+		}
+	}
+#endif
+}
+
+void perf_counters::start()
+{
+#ifdef __linux__
+	for(int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		if(available((counter)i))
+		{
+			ioctl(descriptors[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(descriptors[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+void perf_counters::stop()
+{
+#ifdef __linux__
+	for(int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		if(available((counter)i))
+		{
+			ioctl(descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+			if(read(descriptors[i], &values[i], sizeof(values[i])) != sizeof(values[i]))
+			{
+				values[i] = 0;
+			}
+		}
+	}
+#endif
+}
+
+string perf_counters::summary() const
+{
+	static const char* NAMES[TOTAL_COUNTERS] = { "cycles", "branch misses", "LLC misses" };
+
+	ostringstream out;
+	for(int i = 0; i < TOTAL_COUNTERS; i++)
+	{
+		if(available((counter)i))
+		{
+			out << (out.tellp() > 0 ? ", " : "") << values[i] << " " << NAMES[i];
+		}
+	}
+	return out.str();
+}
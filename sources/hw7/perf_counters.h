@@ -0,0 +1,54 @@
+/*
+ * perf_counters.h
+ *
+ * Hardware counters for the calling thread only: cycles, branch misses
+ * and last level cache misses. Read through perf_event_open on Linux, and
+ * unavailable everywhere else or when the kernel doesn't allow it
+ */
+
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+#include <string>
+
+class perf_counters
+{
+// PUBLIC TYPEDEFS
+public:
+	enum counter { CYCLES, BRANCH_MISSES, CACHE_MISSES, TOTAL_COUNTERS };
+
+// PRIVATE DATA
+private:
+	// File descriptor of each counter, negative if it could not be opened
+	int descriptors[TOTAL_COUNTERS];
+	// Counts between the last start and stop
+	long long values[TOTAL_COUNTERS];
+
+// PUBLIC INTERFACE
+public:
+	// Open the counters, disabled until started
+	perf_counters();
+
+	perf_counters(const perf_counters&) = delete;
+	perf_counters& operator=(const perf_counters&) = delete;
+
+	// Reset the counters and start counting
+	void start();
+
+	// Stop counting and read the counts
+	void stop();
+
+	// Return true if the counter could be opened
+	bool available(counter which) const { return descriptors[which] >= 0; }
+
+	// Count of the counter between the last start and stop
+	long long get(counter which) const { return values[which]; }
+
+	// Available counts as a note for a sort report, empty if none are
+	std::string summary() const;
+
+	// Close the counters
+	~perf_counters();
+};
+
+#endif /* PERF_COUNTERS_H_ */
@@ -0,0 +1,65 @@
+/*
+ * prefix_key.h
+ *
+ * A compact sort key for a string: its first 8 bytes packed big-endian
+ * into an integer next to a pointer to the string. Comparing two keys
+ * compares the integers and only reads the strings when they tie
+ */
+
+#ifndef PREFIX_KEY_H_
+#define PREFIX_KEY_H_
+
+#include <cstdint>
+#include <string>
+
+struct prefix_key
+{
+	// First bytes of the string, the first byte in the highest bits
+	// and zero bytes past the end of the string
+	std::uint64_t prefix;
+	// String the key was made from
+	const std::string* string;
+
+	// Bytes of the string packed into the prefix
+	static const int PREFIX_BYTES = sizeof(std::uint64_t);
+
+	prefix_key() :
+		prefix(0), string(nullptr) {}
+
+	// Extract the key of the given string
+	explicit prefix_key(const std::string& str) :
+		prefix(0), string(&str)
+	{
+		int bytes = str.size() < PREFIX_BYTES ? str.size() : PREFIX_BYTES;
+		for(int i = 0; i < bytes; i++)
+		{
+			prefix |= std::uint64_t((unsigned char)str[i]) << (8 * (PREFIX_BYTES - 1 - i));
+		}
+	}
+
+	// Unsigned byte order on the prefix matches std::string's order, so
+	// the strings only decide when the prefixes are equal
+	friend bool operator<(const prefix_key& a, const prefix_key& b)
+	{
+		if(a.prefix != b.prefix)
+		{
+			return a.prefix < b.prefix;
+		}
+
+		// Equal prefixes of strings this long mean equal first bytes, so only
+		// the rest is compared. Shorter strings can tie on the zero padding
+		if(a.string->size() < PREFIX_BYTES || b.string->size() < PREFIX_BYTES)
+		{
+			return *a.string < *b.string;
+		}
+		return a.string->compare(PREFIX_BYTES, std::string::npos,
+				*b.string, PREFIX_BYTES, std::string::npos) < 0;
+	}
+
+	friend bool operator>(const prefix_key& a, const prefix_key& b)
+	{
+		return b < a;
+	}
+};
+
+#endif /* PREFIX_KEY_H_ */
@@ -0,0 +1,73 @@
+/*
+ * PREFIX KEY SORTER: Time complexity - same as the sorter it wraps
+ *
+ * Sorts (prefix, pointer) keys of the strings with any other sorter
+ * instead of the strings themselves, so most comparisons stay inside
+ * the compact key array. The strings are moved to their sorted
+ * positions once at the end
+ */
+
+#ifndef PREFIX_KEY_SORTER_H_
+#define PREFIX_KEY_SORTER_H_
+
+#include "sorter.h"
+#include "prefix_key.h"
+#include <string>
+#include <vector>
+
+// INTERFACE
+
+template<template<typename> class KeySorter>
+class prefix_key_sorter : public sorter<std::string>
+{
+public:
+	// The name is used in the sort report
+	prefix_key_sorter(int capacity, const std::string& name) :
+		sorter<std::string>(capacity), keySorter(capacity), name(name) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return name; }
+
+	// Sorter that sorts the keys, so its options can be set
+	KeySorter<prefix_key>& key_sorter() { return keySorter; }
+
+private:
+	// Sorts the keys in place of the strings
+	KeySorter<prefix_key> keySorter;
+	// Name of the sort in reports
+	std::string name;
+};
+
+// IMPLEMENTATION
+
+template<template<typename> class KeySorter>
+void prefix_key_sorter<KeySorter>::sort()
+{
+	// Build the keys straight into the key sorter's array
+	prefix_key* keys = keySorter.initialize_in_place(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		keys[i] = prefix_key(array[i]);
+	}
+	keySorter.sort();
+
+	// Each sorted key points back at the string that belongs in its position
+	const prefix_key* sorted = keySorter.get_array();
+	std::vector<int> source(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		source[i] = sorted[i].string - array;
+	}
+	apply_permutation(source);
+}
+
+template<template<typename> class KeySorter>
+void prefix_key_sorter<KeySorter>::sort_report()
+{
+	sorter<std::string>::sort_report(name);
+}
+
+#endif /* PREFIX_KEY_SORTER_H_ */
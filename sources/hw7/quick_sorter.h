@@ -6,7 +6,12 @@
 #define QUICK_SORTER_H_
 
 #include "sorter.h"
+#include "sort_kernels.h"
+#include "work_stealing_pool.h"
+#include "sorting_network.h"
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 // INTERFACE
 
@@ -14,22 +19,64 @@ template<typename Type>
 class quick_sorter : public sorter<Type>
 {
 public:
-	quick_sorter(int capacity) :
-		sorter<Type>(capacity) {}
+	// Subranges smaller than this are sorted serially by parallel sorts
+	static const int DEFAULT_GRAIN_SIZE = 2048;
+
+	// Threads above 1 sort independent subranges on a work-stealing pool
+	quick_sorter(int capacity, int threadCount = 1, int grainSize = DEFAULT_GRAIN_SIZE) :
+		sorter<Type>(capacity), threadCount(threadCount), grainSize(grainSize), threeWay(false) {}
 
 	void sort();
 
 	void sort_report();
 
+	std::string get_name() const
+	{
+		return std::string(threadCount > 1 ? "Parallel " : "") + (threeWay ? "3-Way " : "") + "Quick Sort";
+	}
+
+	void set_thread_count(int threads) { threadCount = threads; }
+	void set_grain_size(int grain) { grainSize = grain; }
+
+	// Three-way partitioning groups the keys equal to the pivot in the
+	// middle and never sorts them again, so k distinct keys take O(nlogk)
+	void set_three_way(bool enabled) { threeWay = enabled; }
+
 private:
+	// Number of threads used to sort, 1 sorts on the calling thread
+	int threadCount;
+	// Subranges this size or smaller are not split into more tasks
+	int grainSize;
+	// Partition into less, equal and greater instead of less and not less
+	bool threeWay;
+	// Workers for the parallel sort, started on the first parallel sort
+	std::unique_ptr<work_stealing_pool> pool;
+
+	bool sorts_in_parallel() const { return threadCount > 1 && this->arrayLen > grainSize; }
+
 	// Function recursively called to quicksort the list
 	void sort_recursive(int arStart, int arEnd);
 
+	// Partition the range, hand the upper part to the pool and keep
+	// partitioning the lower part until it is below the grain size
+	void sort_task(int arStart, int arEnd);
+
 	// Perform the partition step of quicksort
-	// Take the element at arEnd - 1 as the PIVOT, move all elements bigger
-	// than PIVOT above PIVOT and all elements less than PIVOT below PIVOT,
-	// and return the new index of the PIVOT
+	// Take the median-of-three (ninther for big ranges) as the PIVOT, move
+	// all elements bigger than PIVOT above PIVOT and all elements less than
+	// PIVOT below PIVOT, and return the new index of the PIVOT
 	int partition(int arStart, int arEnd);
+
+	// Partition around the median-of-three (ninther for big ranges), moved
+	// to arEnd - 1, into elements less than, equal to and greater than the
+	// PIVOT, Bentley-McIlroy style: keys
+	// equal to the PIVOT are swapped to both ends while scanning, then
+	// into the middle. Sets [equalStart, equalEnd) to the equal keys
+	void partition_three_way(int arStart, int arEnd, int& equalStart, int& equalEnd);
+
+	// Partition with the configured scheme, so [arStart, lowEnd) and
+	// [highStart, arEnd) are what is left to sort
+	void split(int arStart, int arEnd, int& lowEnd, int& highStart);
 };
 
 // IMPLEMENTATION
@@ -37,51 +84,173 @@ private:
 template<typename Type>
 void quick_sorter<Type>::sort()
 {
-	sort_recursive(0, this->arrayLen);
+	if(threadCount > 1 && this->arrayLen > grainSize)
+	{
+		// (Re)start the pool if the thread count changed
+		if(!pool || pool->thread_count() != threadCount)
+		{
+			pool.reset(new work_stealing_pool(threadCount));
+		}
+
+		pool->spawn([this]() { sort_task(0, this->arrayLen); });
+		pool->wait();
+	}
+	else
+	{
+		sort_recursive(0, this->arrayLen);
+	}
 }
 
 template<typename Type>
 void quick_sorter<Type>::sort_report()
 {
-	sorter<Type>::sort_report("Quick Sort");
+	if(threadCount <= 1)
+	{
+		sorter<Type>::sort_report(get_name());
+		return;
+	}
+
+	// Sort a copy of the input serially first so the speedup is measured on the same data
+	std::vector<Type> input(this->array, this->array + this->arrayLen);
+	int threads = threadCount;
+
+	threadCount = 1;
+	auto serialBegin = std::chrono::steady_clock::now();
+	sort();
+	auto serialTime = std::chrono::steady_clock::now() - serialBegin;
+
+	std::copy(input.begin(), input.end(), this->array);
+	threadCount = threads;
+	std::string counters;
+	auto parallelTime = this->instrumented_sort(counters);
+
+	// Output the parallel time next to the serial time it is compared against
+	std::ostringstream note;
+	note << threads << " threads, serial " << std::fixed << std::setprecision(3)
+		<< std::chrono::duration<double, std::milli>(serialTime).count()
+		<< " milliseconds, " << std::setprecision(2)
+		<< std::chrono::duration<double>(serialTime).count() / std::chrono::duration<double>(parallelTime).count()
+		<< "x speedup" << (counters.empty() ? "" : ", " + counters);
+	sorter<Type>::print_report(std::cout, get_name(), parallelTime, note.str());
 }
 
 template<typename Type>
 void quick_sorter<Type>::sort_recursive(int start, int end)
 {
+	recursion_guard<Type> guard;
+
+	// Small ranges of numbers go through a sorting network instead
+	if constexpr(sorting_network::supports<Type>::value)
+	{
+		if(end - start <= sorting_network::MAX_BLOCK)
+		{
+			sorting_network::sort(this->array + start, end - start);
+			return;
+		}
+	}
+
 	if(start < end)
 	{
-		// Get the pivot
-		int pivot = partition(start, end);
+		// Partition around the pivot
+		int lowEnd, highStart;
+		split(start, end, lowEnd, highStart);
 
 		// Repeat quick sort on sub-array above and below the pivot
-		sort_recursive(start, pivot - 1);
-		sort_recursive(pivot + 1, end);
+		sort_recursive(start, lowEnd);
+		sort_recursive(highStart, end);
+	}
+}
+
+template<typename Type>
+void quick_sorter<Type>::sort_task(int start, int end)
+{
+	while(end - start > grainSize)
+	{
+		int lowEnd, highStart;
+		split(start, end, lowEnd, highStart);
+
+		// The part above the pivot is independent, so another worker can steal it
+		pool->spawn([this, highStart, end]() { sort_task(highStart, end); });
+		end = lowEnd;
 	}
+
+	sort_recursive(start, end);
 }
 
 template<typename Type>
 int quick_sorter<Type>::partition(int start, int end)
 {
-	int pivotPos = start;	// Position the pivot will be moved to at the end
+	// A sampled pivot keeps sorted and reversed input at O(nlogn), and the
+	// Hoare partition splits runs of equal keys down the middle
+	int pivot = sort_kernels<Type>::choose_pivot(this->array, start, end);
+	return sort_kernels<Type>::partition(this->array, start, end, pivot);
+}
+
+template<typename Type>
+void quick_sorter<Type>::partition_three_way(int start, int end, int& equalStart, int& equalEnd)
+{
+	Type* array = this->array;
+	// Park a sampled pivot at the end so sorted input still splits evenly
+	std::swap(array[sort_kernels<Type>::choose_pivot(array, start, end)], array[end - 1]);
+	const Type& pivot = array[end - 1];
 
-	// Loop from the start up to the element before the end
-	for(int i = start; i < end - 1; i++)
+	// [start, lessBegin) and (greaterEnd, end - 1) collect keys equal to the
+	// pivot, [lessBegin, low) keys less and (high, greaterEnd] keys greater
+	int lessBegin = start;
+	int low = start;
+	int high = end - 2;
+	int greaterEnd = end - 2;
+	while(true)
 	{
-		// If the current element is less than the element
-		// at the end, swap it with the current pivot position
-		// and advance the pivot position
-		if(this->array[i] < this->array[end - 1])
+		while(low <= high && !(pivot < array[low]))
 		{
-			std::swap(this->array[i], this->array[pivotPos]);
-			pivotPos++;
+			if(!(array[low] < pivot))
+			{
+				std::swap(array[lessBegin++], array[low]);
+			}
+			low++;
 		}
+		while(high >= low && !(array[high] < pivot))
+		{
+			if(!(pivot < array[high]))
+			{
+				std::swap(array[high], array[greaterEnd--]);
+			}
+			high--;
+		}
+
+		if(low > high)
+		{
+			break;
+		}
+		std::swap(array[low++], array[high--]);
 	}
 
-	// Swap the number at the end with the pivot position found
-	std::swap(this->array[pivotPos], this->array[end - 1]);
+	// Swap the equal keys at both ends, pivot included, into the middle
+	int lessCount = low - lessBegin;
+	int greaterCount = greaterEnd - high;
+	int leftEqual = lessBegin - start;
+	int rightEqual = end - 1 - greaterEnd;
+
+	std::swap_ranges(array + start, array + start + std::min(leftEqual, lessCount), array + low - std::min(leftEqual, lessCount));
+	std::swap_ranges(array + low, array + low + std::min(rightEqual, greaterCount), array + end - std::min(rightEqual, greaterCount));
+
+	equalStart = start + lessCount;
+	equalEnd = end - greaterCount;
+}
 
-	return pivotPos;
+template<typename Type>
+void quick_sorter<Type>::split(int start, int end, int& lowEnd, int& highStart)
+{
+	if(threeWay)
+	{
+		partition_three_way(start, end, lowEnd, highStart);
+	}
+	else
+	{
+		lowEnd = partition(start, end);
+		highStart = lowEnd + 1;
+	}
 }
 
 
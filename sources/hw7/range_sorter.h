@@ -0,0 +1,88 @@
+/*
+ * RANGE SORTER: Time complexity - depends on the sort used
+ *
+ * Sorts the caller's own contiguous range in place, in the order given by
+ * Compare applied to the keys KeyFn extracts. Unlike the sorter classes
+ * nothing is copied into an internal array and nothing is virtual: the
+ * order is a template argument, so it is inlined into the kernels
+ */
+
+#ifndef RANGE_SORTER_H_
+#define RANGE_SORTER_H_
+
+#include "sort_order.h"
+#include "insertion_sorter.h"
+#include "heap_sorter.h"
+#include "intro_sorter.h"
+#include "merge_sorter.h"
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type, typename Compare = std::less<>, typename KeyFn = identity_key>
+class range_sorter
+{
+public:
+	// The default compare and key give exactly operator<, so they sort with
+	// default_order itself, which kernels check for to take their fast paths
+	typedef typename std::conditional<std::is_same<Compare, std::less<>>::value && std::is_same<KeyFn, identity_key>::value,
+			default_order, sort_order<Compare, KeyFn>>::type order;
+
+	// Introsort [first, last) in place
+	static void sort(Type* first, Type* last);
+
+	// Merge sort [first, last) in place, keeping equal keys in their order
+	static void stable_sort(Type* first, Type* last);
+
+	// Heap sort [first, last) in place
+	static void heap_sort(Type* first, Type* last);
+
+	// Insertion sort [first, last) in place
+	static void insertion_sort(Type* first, Type* last);
+
+	// The same sorts of a whole contiguous range with data() and size(),
+	// such as a std::vector, std::array or C array
+	template<typename Range>
+	static void sort(Range& range) { sort(std::data(range), std::data(range) + std::size(range)); }
+
+	template<typename Range>
+	static void stable_sort(Range& range) { stable_sort(std::data(range), std::data(range) + std::size(range)); }
+
+	template<typename Range>
+	static void heap_sort(Range& range) { heap_sort(std::data(range), std::data(range) + std::size(range)); }
+
+	template<typename Range>
+	static void insertion_sort(Range& range) { insertion_sort(std::data(range), std::data(range) + std::size(range)); }
+};
+
+// IMPLEMENTATION
+
+template<typename Type, typename Compare, typename KeyFn>
+void range_sorter<Type, Compare, KeyFn>::sort(Type* first, Type* last)
+{
+	intro_sorter<Type>::intro_sort(first, 0, last - first, order());
+}
+
+template<typename Type, typename Compare, typename KeyFn>
+void range_sorter<Type, Compare, KeyFn>::stable_sort(Type* first, Type* last)
+{
+	std::vector<Type> scratch(last - first);
+	merge_sorter<Type>::merge_sort(first, scratch.data(), 0, last - first, order());
+}
+
+template<typename Type, typename Compare, typename KeyFn>
+void range_sorter<Type, Compare, KeyFn>::heap_sort(Type* first, Type* last)
+{
+	heap_sorter<Type>::heap_sort(first, last - first, order());
+}
+
+template<typename Type, typename Compare, typename KeyFn>
+void range_sorter<Type, Compare, KeyFn>::insertion_sort(Type* first, Type* last)
+{
+	insertion_sorter<Type>::insertion_sort(first, 0, last - first, order());
+}
+
+#endif /* RANGE_SORTER_H_ */
@@ -0,0 +1,323 @@
+/*
+ * RUN SORTER: Time complexity - O(n) on sorted input, O(nlogn) worst case, stable
+ *
+ * Natural merge sort in the style of Timsort. The array is split into the
+ * ascending and descending runs it already has, short runs are extended
+ * with binary insertion sort, and the runs are merged in the order
+ * powersort picks. Merges gallop through stretches where one run keeps
+ * winning, so merging runs that barely overlap is close to free
+ */
+
+#ifndef RUN_SORTER_H_
+#define RUN_SORTER_H_
+
+#include "sorter.h"
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class run_sorter : public sorter<Type>
+{
+public:
+	run_sorter(int capacity) :
+		sorter<Type>(capacity) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return "Run Sort"; }
+
+	// Stable sort the given array of the given length in place, using
+	// the scratch vector as temporary storage
+	static void run_sort(Type* array, int length, std::vector<Type>& scratch);
+
+private:
+	// One element of either run winning this many times in a row starts galloping
+	static const int MIN_GALLOP = 7;
+
+	// A sorted run waiting to be merged, with the powersort power of
+	// the boundary between it and the run after it
+	struct pending_run
+	{
+		int start;
+		int length;
+		int power;
+	};
+
+	// Merge buffer, kept between sorts so it is only allocated once
+	std::vector<Type> scratch;
+
+	// Shortest run worth merging for an array of the given length:
+	// between 32 and 64, chosen so the number of runs is close to a power of 2
+	static int min_run_length(int length);
+
+	// Return the end of the run starting at start, reversing it if it descends
+	static int find_run(Type* array, int start, int end);
+
+	// Sort [start, end) by binary insertion, given [start, sortedEnd) is sorted
+	static void binary_insertion_sort(Type* array, int start, int sortedEnd, int end);
+
+	// Powersort power of the boundary between the given adjacent runs in an array of length n
+	static int node_power(int start1, int length1, int length2, int n);
+
+	// Merge the adjacent sorted runs [start, middle) and [middle, end)
+	static void merge_runs(Type* array, int start, int middle, int end, std::vector<Type>& scratch);
+
+	// Number of the first count elements of base that are not greater than key
+	static int gallop_right(const Type& key, const Type* base, int count);
+
+	// Number of the first count elements of base that are less than key
+	static int gallop_left(const Type& key, const Type* base, int count);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void run_sorter<Type>::sort()
+{
+	run_sort(this->array, this->arrayLen, scratch);
+}
+
+template<typename Type>
+void run_sorter<Type>::sort_report()
+{
+	sorter<Type>::sort_report(get_name());
+}
+
+template<typename Type>
+void run_sorter<Type>::run_sort(Type* array, int length, std::vector<Type>& scratch)
+{
+	if(length < 2)
+	{
+		return;
+	}
+
+	int minRun = min_run_length(length);
+	std::vector<pending_run> runs;
+
+	for(int start = 0; start < length; )
+	{
+		// Take the run that is already there, extended to the minimum length
+		int end = find_run(array, start, length);
+		if(end - start < minRun)
+		{
+			int extendedEnd = std::min(start + minRun, length);
+			binary_insertion_sort(array, start, end, extendedEnd);
+			end = extendedEnd;
+		}
+
+		// Merge the runs on the stack that sit deeper in the merge tree
+		// than the boundary in front of the new run
+		if(!runs.empty())
+		{
+			int power = node_power(runs.back().start, runs.back().length, end - start, length);
+			while(runs.size() > 1 && runs[runs.size() - 2].power > power)
+			{
+				pending_run top = runs.back();
+				runs.pop_back();
+				merge_runs(array, runs.back().start, top.start, top.start + top.length, scratch);
+				runs.back().length += top.length;
+			}
+			runs.back().power = power;
+		}
+		runs.push_back(pending_run { start, end - start, 0 });
+
+		start = end;
+	}
+
+	// Merge what is left from the top of the stack down
+	while(runs.size() > 1)
+	{
+		pending_run top = runs.back();
+		runs.pop_back();
+		merge_runs(array, runs.back().start, top.start, top.start + top.length, scratch);
+		runs.back().length += top.length;
+	}
+}
+
+template<typename Type>
+int run_sorter<Type>::min_run_length(int length)
+{
+	// Take the top 6 bits of the length, plus one if any of the others are set
+	int remainder = 0;
+	while(length >= 64)
+	{
+		remainder |= length & 1;
+		length >>= 1;
+	}
+	return length + remainder;
+}
+
+template<typename Type>
+int run_sorter<Type>::find_run(Type* array, int start, int end)
+{
+	int runEnd = start + 1;
+	if(runEnd == end)
+	{
+		return runEnd;
+	}
+
+	if(array[runEnd] < array[start])
+	{
+		// Only strictly descending runs are reversed, so equal elements keep their order
+		while(runEnd < end && array[runEnd] < array[runEnd - 1])
+		{
+			runEnd++;
+		}
+		std::reverse(array + start, array + runEnd);
+	}
+	else
+	{
+		while(runEnd < end && !(array[runEnd] < array[runEnd - 1]))
+		{
+			runEnd++;
+		}
+	}
+
+	return runEnd;
+}
+
+template<typename Type>
+void run_sorter<Type>::binary_insertion_sort(Type* array, int start, int sortedEnd, int end)
+{
+	for(int i = sortedEnd; i < end; i++)
+	{
+		// Insert after any equal elements so the sort stays stable
+		Type value = std::move(array[i]);
+		Type* position = std::upper_bound(array + start, array + i, value);
+		std::move_backward(position, array + i, array + i + 1);
+		*position = std::move(value);
+	}
+}
+
+template<typename Type>
+int run_sorter<Type>::node_power(int start1, int length1, int length2, int n)
+{
+	// Compare the binary expansions of the midpoints of the two runs,
+	// as fractions of n, and return the first bit where they differ
+	long long a = 2LL * start1 + length1;
+	long long b = a + length1 + length2;
+	int power = 0;
+	while(true)
+	{
+		power++;
+		if(a >= n)
+		{
+			a -= n;
+			b -= n;
+		}
+		else if(b >= n)
+		{
+			return power;
+		}
+		a <<= 1;
+		b <<= 1;
+	}
+}
+
+template<typename Type>
+void run_sorter<Type>::merge_runs(Type* array, int start, int middle, int end, std::vector<Type>& scratch)
+{
+	// Elements of the left run not greater than the right run's first are already in place
+	start += gallop_right(array[middle], array + start, middle - start);
+	if(start == middle)
+	{
+		return;
+	}
+
+	// So are elements of the right run not less than the left run's last
+	end = middle + gallop_left(array[middle - 1], array + middle, end - middle);
+
+	// Move what is left of the left run out of the way and merge it back in
+	scratch.resize(std::max<size_t>(scratch.size(), middle - start));
+	std::move(array + start, array + middle, scratch.begin());
+
+	Type* left = scratch.data();
+	Type* leftEnd = left + (middle - start);
+	Type* right = array + middle;
+	Type* rightEnd = array + end;
+	Type* out = array + start;
+
+	while(left < leftEnd && right < rightEnd)
+	{
+		// Take one element at a time until one run wins often enough
+		int leftWins = 0;
+		int rightWins = 0;
+		while(left < leftEnd && right < rightEnd && leftWins < MIN_GALLOP && rightWins < MIN_GALLOP)
+		{
+			// The left run wins ties, which keeps the merge stable
+			if(*right < *left)
+			{
+				*out++ = std::move(*right++);
+				rightWins++;
+				leftWins = 0;
+			}
+			else
+			{
+				*out++ = std::move(*left++);
+				leftWins++;
+				rightWins = 0;
+			}
+		}
+
+		// Then move whole stretches at once for as long as they stay long
+		while(left < leftEnd && right < rightEnd)
+		{
+			int leftCount = gallop_right(*right, left, leftEnd - left);
+			out = std::move(left, left + leftCount, out);
+			left += leftCount;
+			if(left == leftEnd)
+			{
+				break;
+			}
+
+			int rightCount = gallop_left(*left, right, rightEnd - right);
+			out = std::move(right, right + rightCount, out);
+			right += rightCount;
+
+			if(leftCount < MIN_GALLOP && rightCount < MIN_GALLOP)
+			{
+				break;
+			}
+		}
+	}
+
+	// Whatever is left of the right run is already in place
+	std::move(left, leftEnd, out);
+}
+
+template<typename Type>
+int run_sorter<Type>::gallop_right(const Type& key, const Type* base, int count)
+{
+	// Probe at 0, 1, 3, 7... until an element is greater than the key,
+	// then binary search the last gap
+	int last = 0;
+	int probe = 0;
+	while(probe < count && !(key < base[probe]))
+	{
+		last = probe + 1;
+		probe = 2 * probe + 1;
+	}
+	return std::upper_bound(base + last, base + std::min(probe, count), key) - base;
+}
+
+template<typename Type>
+int run_sorter<Type>::gallop_left(const Type& key, const Type* base, int count)
+{
+	int last = 0;
+	int probe = 0;
+	while(probe < count && base[probe] < key)
+	{
+		last = probe + 1;
+		probe = 2 * probe + 1;
+	}
+	return std::lower_bound(base + last, base + std::min(probe, count), key) - base;
+}
+
+#endif /* RUN_SORTER_H_ */
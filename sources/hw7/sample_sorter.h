@@ -0,0 +1,246 @@
+/*
+ * SAMPLE SORTER: Time complexity - O(nlogn)
+ *
+ * Picks splitters from a sorted sample, then every thread classifies its
+ * own slice of the array into buckets by walking a splitter tree, and
+ * scatters its elements straight to where their bucket will go. The
+ * buckets are independent, so they are then sorted in parallel. Threads
+ * only meet at the end of each phase
+ */
+
+#ifndef SAMPLE_SORTER_H_
+#define SAMPLE_SORTER_H_
+
+#include "sorter.h"
+#include "intro_sorter.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class sample_sorter : public sorter<Type>
+{
+public:
+	// Time spent in each phase of the last sort
+	struct phase_times
+	{
+		std::chrono::nanoseconds sample;
+		std::chrono::nanoseconds classify;
+		std::chrono::nanoseconds scatter;
+		std::chrono::nanoseconds localSort;
+	};
+
+	sample_sorter(int capacity, int threadCount = 1) :
+		sorter<Type>(capacity), threadCount(threadCount), times() {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return "Sample Sort"; }
+
+	void set_thread_count(int threads) { threadCount = threads; }
+
+	const phase_times& get_phase_times() const { return times; }
+
+private:
+	// Arrays shorter than this are sorted without sampling
+	static const int MIN_SAMPLE_SORT = 4096;
+	// Fewest elements worth a bucket of their own, on average
+	static const int MIN_BUCKET_SIZE = 256;
+	// Most buckets, and buckets per thread to aim for so stealing can even out the load
+	static const int MAX_BUCKETS = 256;
+	static const int BUCKETS_PER_THREAD = 8;
+	// Samples taken per bucket
+	static const int OVERSAMPLING = 16;
+
+	// Number of threads used to sort, 1 sorts on the calling thread
+	int threadCount;
+	phase_times times;
+	// Elements scattered into their buckets, kept between sorts
+	std::vector<Type> scratch;
+	// Bucket of every element, filled by classify and used by scatter
+	std::vector<int> bucketOf;
+	// Splitters in tree order: the children of node i are 2i and 2i + 1
+	std::vector<Type> splitterTree;
+	// Workers for the sort, started on the first sort
+	std::unique_ptr<work_stealing_pool> pool;
+
+	// The phases run on the pool even with one thread
+	bool sorts_in_parallel() const { return this->arrayLen >= MIN_SAMPLE_SORT; }
+
+	// Choose bucketCount - 1 splitters from a sorted sample and lay them out as a tree
+	void choose_splitters(int bucketCount);
+
+	// Lay out the sorted splitters in [low, high) under the given tree node
+	void build_tree(const std::vector<Type>& splitters, int node, int low, int high);
+
+	// Bucket of the element: the number of splitters not greater than it
+	int classify(const Type& element, int bucketCount) const;
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void sample_sorter<Type>::sort()
+{
+	times = phase_times();
+	int length = this->arrayLen;
+	if(length < MIN_SAMPLE_SORT)
+	{
+		intro_sorter<Type>::intro_sort(this->array, 0, length);
+		return;
+	}
+
+	// A power of two buckets so the tree is complete
+	int bucketCount = 2;
+	while(bucketCount < MAX_BUCKETS && bucketCount < threadCount * BUCKETS_PER_THREAD
+			&& bucketCount * 2 * MIN_BUCKET_SIZE <= length)
+	{
+		bucketCount *= 2;
+	}
+
+	// (Re)start the pool if the thread count changed
+	int threads = std::max(1, threadCount);
+	if(!pool || pool->thread_count() != threads)
+	{
+		pool.reset(new work_stealing_pool(threads));
+	}
+
+	auto phaseBegin = std::chrono::steady_clock::now();
+	auto endPhase = [&phaseBegin](std::chrono::nanoseconds& time) {
+		auto now = std::chrono::steady_clock::now();
+		time = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseBegin);
+		phaseBegin = now;
+	};
+
+	choose_splitters(bucketCount);
+	endPhase(times.sample);
+
+	// Each thread classifies its own slice and counts its buckets
+	std::vector<int> sliceBounds(threads + 1);
+	for(int slice = 0; slice <= threads; slice++)
+	{
+		sliceBounds[slice] = (long long)length * slice / threads;
+	}
+	bucketOf.resize(length);
+	std::vector<std::vector<int>> counts(threads, std::vector<int>(bucketCount, 0));
+	pool->parallel_for(threads, [this, &sliceBounds, &counts, bucketCount](int slice) {
+		std::vector<int>& count = counts[slice];
+		for(int i = sliceBounds[slice]; i < sliceBounds[slice + 1]; i++)
+		{
+			bucketOf[i] = classify(this->array[i], bucketCount);
+			count[bucketOf[i]]++;
+		}
+	});
+	endPhase(times.classify);
+
+	// Bucket by bucket, each slice writes after the slices before it,
+	// so every thread gets its own disjoint part of every bucket
+	std::vector<int> bucketBounds(bucketCount + 1, 0);
+	std::vector<std::vector<int>> next(threads, std::vector<int>(bucketCount));
+	int offset = 0;
+	for(int bucket = 0; bucket < bucketCount; bucket++)
+	{
+		bucketBounds[bucket] = offset;
+		for(int slice = 0; slice < threads; slice++)
+		{
+			next[slice][bucket] = offset;
+			offset += counts[slice][bucket];
+		}
+	}
+	bucketBounds[bucketCount] = offset;
+
+	scratch.resize(length);
+	pool->parallel_for(threads, [this, &sliceBounds, &next](int slice) {
+		std::vector<int>& position = next[slice];
+		for(int i = sliceBounds[slice]; i < sliceBounds[slice + 1]; i++)
+		{
+			scratch[position[bucketOf[i]]++] = std::move(this->array[i]);
+		}
+	});
+	endPhase(times.scatter);
+
+	// Sort every bucket and move it back, stealing evens out uneven buckets
+	pool->parallel_for(bucketCount, [this, &bucketBounds](int bucket) {
+		intro_sorter<Type>::intro_sort(scratch.data(), bucketBounds[bucket], bucketBounds[bucket + 1]);
+		std::move(scratch.begin() + bucketBounds[bucket], scratch.begin() + bucketBounds[bucket + 1],
+				this->array + bucketBounds[bucket]);
+	});
+	endPhase(times.localSort);
+}
+
+template<typename Type>
+void sample_sorter<Type>::sort_report()
+{
+	std::string note;
+	auto time = this->instrumented_sort(note);
+
+	// Output the time of each phase next to the total
+	auto millis = [](std::chrono::nanoseconds phase) {
+		return std::chrono::duration<double, std::milli>(phase).count();
+	};
+	std::ostringstream phases;
+	phases << threadCount << " threads, sample " << std::fixed << std::setprecision(3)
+		<< millis(times.sample) << " ms, classify " << millis(times.classify)
+		<< " ms, scatter " << millis(times.scatter) << " ms, local sort "
+		<< millis(times.localSort) << " ms" << (note.empty() ? "" : ", " + note);
+	sorter<Type>::print_report(std::cout, get_name(), time, phases.str());
+}
+
+template<typename Type>
+void sample_sorter<Type>::choose_splitters(int bucketCount)
+{
+	// Sample with a fixed seed so runs on the same input do the same work
+	std::minstd_rand random(this->arrayLen);
+	std::uniform_int_distribution<int> index(0, this->arrayLen - 1);
+
+	std::vector<Type> sample(bucketCount * OVERSAMPLING);
+	for(Type& element : sample)
+	{
+		element = this->array[index(random)];
+	}
+	intro_sorter<Type>::intro_sort(sample.data(), 0, sample.size());
+
+	std::vector<Type> splitters;
+	for(int bucket = 1; bucket < bucketCount; bucket++)
+	{
+		splitters.push_back(sample[bucket * OVERSAMPLING]);
+	}
+
+	splitterTree.resize(bucketCount);
+	build_tree(splitters, 1, 0, splitters.size());
+}
+
+template<typename Type>
+void sample_sorter<Type>::build_tree(const std::vector<Type>& splitters, int node, int low, int high)
+{
+	if(low < high)
+	{
+		int middle = low + (high - low) / 2;
+		splitterTree[node] = splitters[middle];
+		build_tree(splitters, 2 * node, low, middle);
+		build_tree(splitters, 2 * node + 1, middle + 1, high);
+	}
+}
+
+template<typename Type>
+int sample_sorter<Type>::classify(const Type& element, int bucketCount) const
+{
+	// Every level goes left or right by adding the comparison to the
+	// index, so there is no branch to mispredict
+	int node = 1;
+	while(node < bucketCount)
+	{
+		node = 2 * node + !(element < splitterTree[node]);
+	}
+	return node - bucketCount;
+}
+
+#endif /* SAMPLE_SORTER_H_ */
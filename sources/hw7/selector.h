@@ -0,0 +1,188 @@
+/*
+ * selector.h
+ *
+ * Order statistics without a full sort. Selection is introselect:
+ * quickselect with intro sort's pivot and partition that switches to a
+ * median of medians pivot once partitioning goes badly, so it stays O(n).
+ * Partial sort only partitions the parts that overlap the first k
+ * positions, and top_k keeps the k smallest values of a stream in a heap
+ */
+
+#ifndef SELECTOR_H_
+#define SELECTOR_H_
+
+#include "sort_kernels.h"
+#include <algorithm>
+#include <istream>
+#include <utility>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class selector
+{
+public:
+	// Rearrange the array so the element at index k is the one a full sort
+	// would put there, nothing before it is bigger and nothing after it smaller
+	static void select(Type* array, int length, int k);
+
+	// Rearrange the array so its first k elements are its k smallest, in order
+	static void partial_sort(Type* array, int length, int k);
+
+	// Return the k smallest values of the stream in order, holding
+	// at most k + 1 of them at any time
+	static std::vector<Type> top_k(std::istream& in, int k);
+
+private:
+	// Ranges this small or smaller are insertion sorted
+	static const int INSERTION_CUTOFF = 16;
+	// Elements per group of the median of medians
+	static const int GROUP_SIZE = 5;
+
+	// Select the element for index k in [start, end)
+	static void introselect(Type* array, int start, int end, int k, int depthBudget);
+
+	// Sort the part of [start, end) that overlaps [start, k)
+	static void partial_sort_recursive(Type* array, int start, int end, int k, int depthBudget);
+
+	// Return the index of the pivot for [start, end) while the budget lasts,
+	// and of the median of medians once it runs out
+	static int choose_pivot(Type* array, int start, int end, int depthBudget);
+
+	// Move the median of the medians of groups of 5 to the front of the
+	// range and return its index. It is bigger and smaller than at least
+	// 3/10 of the range each, so no partition around it goes badly
+	static int median_of_medians(Type* array, int start, int end);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void selector<Type>::select(Type* array, int length, int k)
+{
+	if(k >= 0 && k < length)
+	{
+		introselect(array, 0, length, k, sort_kernels<Type>::depth_budget(length));
+	}
+}
+
+template<typename Type>
+void selector<Type>::partial_sort(Type* array, int length, int k)
+{
+	partial_sort_recursive(array, 0, length, std::min(k, length), sort_kernels<Type>::depth_budget(length));
+}
+
+template<typename Type>
+std::vector<Type> selector<Type>::top_k(std::istream& in, int k)
+{
+	// Max heap of the k smallest values so far, so the biggest
+	// of them is the one to drop when a smaller value comes in
+	std::vector<Type> heap;
+	if(k <= 0)
+	{
+		return heap;
+	}
+	heap.reserve(k + 1);
+
+	Type value;
+	while(in >> value)
+	{
+		if((int)heap.size() < k)
+		{
+			heap.push_back(std::move(value));
+			std::push_heap(heap.begin(), heap.end());
+		}
+		else if(value < heap.front())
+		{
+			std::pop_heap(heap.begin(), heap.end());
+			heap.back() = std::move(value);
+			std::push_heap(heap.begin(), heap.end());
+		}
+	}
+
+	std::sort_heap(heap.begin(), heap.end());
+	return heap;
+}
+
+template<typename Type>
+void selector<Type>::introselect(Type* array, int start, int end, int k, int depthBudget)
+{
+	while(end - start > INSERTION_CUTOFF)
+	{
+		int pivot = sort_kernels<Type>::partition(array, start, end, choose_pivot(array, start, end, depthBudget));
+		if(depthBudget > 0)
+		{
+			depthBudget--;
+		}
+
+		// Keep going only on the side that holds index k
+		if(k == pivot)
+		{
+			return;
+		}
+		else if(k < pivot)
+		{
+			end = pivot;
+		}
+		else
+		{
+			start = pivot + 1;
+		}
+	}
+
+	sort_kernels<Type>::insertion_sort(array, start, end);
+}
+
+template<typename Type>
+void selector<Type>::partial_sort_recursive(Type* array, int start, int end, int k, int depthBudget)
+{
+	while(end - start > INSERTION_CUTOFF && start < k)
+	{
+		int pivot = sort_kernels<Type>::partition(array, start, end, choose_pivot(array, start, end, depthBudget));
+		if(depthBudget > 0)
+		{
+			depthBudget--;
+		}
+
+		// The lower side is needed in full, the upper side only up to k
+		partial_sort_recursive(array, start, pivot, k, depthBudget);
+		start = pivot + 1;
+	}
+
+	if(start < k)
+	{
+		sort_kernels<Type>::insertion_sort(array, start, end);
+	}
+}
+
+template<typename Type>
+int selector<Type>::choose_pivot(Type* array, int start, int end, int depthBudget)
+{
+	if(depthBudget == 0)
+	{
+		return median_of_medians(array, start, end);
+	}
+	return sort_kernels<Type>::choose_pivot(array, start, end);
+}
+
+template<typename Type>
+int selector<Type>::median_of_medians(Type* array, int start, int end)
+{
+	// Sort each group of 5 and gather the medians at the front of the range
+	int medians = 0;
+	for(int group = start; group < end; group += GROUP_SIZE)
+	{
+		int groupEnd = std::min(group + GROUP_SIZE, end);
+		sort_kernels<Type>::insertion_sort(array, group, groupEnd);
+		std::swap(array[start + medians], array[group + (groupEnd - group) / 2]);
+		medians++;
+	}
+
+	// Select the median of the medians, again with the guaranteed pivot
+	int middle = start + medians / 2;
+	introselect(array, start, start + medians, middle, 0);
+	return middle;
+}
+
+#endif /* SELECTOR_H_ */
@@ -0,0 +1,109 @@
+/*
+ * sort_benchmark.cpp
+ */
+
+#include "sort_benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+using namespace std;
+
+sort_benchmark::sort_benchmark(int warmups, int repetitions) :
+	warmups(max(0, warmups)), repetitions(max(1, repetitions)) {}
+
+const benchmark_result& sort_benchmark::add_result(const string& input, const string& sortType,
+		int count, vector<double>& times)
+{
+	std::sort(times.begin(), times.end());
+	int total = times.size();
+
+	double sum = 0;
+	for(double time : times)
+	{
+		sum += time;
+	}
+	double mean = sum / total;
+
+	// Sample standard deviation, zero for a single run
+	double squares = 0;
+	for(double time : times)
+	{
+		squares += (time - mean) * (time - mean);
+	}
+	double stddev = total > 1 ? sqrt(squares / (total - 1)) : 0;
+
+	// Median of an even count is the mean of the middle two,
+	// p95 is the nearest rank
+	double median = total % 2 ? times[total / 2] : (times[total / 2 - 1] + times[total / 2]) / 2;
+	int p95Rank = (int)ceil(0.95 * total);
+	double p95 = times[max(1, p95Rank) - 1];
+
+	results.push_back(benchmark_result { input, sortType, count, total,
+		median, p95, mean, stddev, times.front(), times.back() });
+	return results.back();
+}
+
+void sort_benchmark::print_report(ostream& out, const benchmark_result& result)
+{
+	// Times on the console are in milliseconds
+	auto millis = [](double nanos) { return nanos / 1e6; };
+
+	out << setfill('-') << left;
+	out << setw(23) << (result.sortType + ":") << ">: median " << fixed << setprecision(3)
+		<< millis(result.median) << " ms, p95 " << millis(result.p95)
+		<< " ms, stddev " << millis(result.stddev) << " ms (" << result.repetitions << " runs)";
+	out << setfill(' ') << right << defaultfloat << endl;
+}
+
+void sort_benchmark::write_csv(ostream& out) const
+{
+	out << "input,sorter,count,repetitions,median_ns,p95_ns,mean_ns,stddev_ns,min_ns,max_ns" << endl;
+	out << fixed << setprecision(0);
+	for(const benchmark_result& result : results)
+	{
+		out << result.input << ',' << result.sortType << ',' << result.count << ','
+			<< result.repetitions << ',' << result.median << ',' << result.p95 << ','
+			<< result.mean << ',' << result.stddev << ',' << result.min << ','
+			<< result.max << endl;
+	}
+	out << defaultfloat;
+}
+
+void sort_benchmark::write_json(ostream& out) const
+{
+	out << '[' << endl;
+	out << fixed << setprecision(0);
+	for(int i = 0; i < (int)results.size(); i++)
+	{
+		const benchmark_result& result = results[i];
+		out << "  {\"input\": ";
+		write_json_string(out, result.input);
+		out << ", \"sorter\": ";
+		write_json_string(out, result.sortType);
+		out << ", \"count\": " << result.count
+			<< ", \"repetitions\": " << result.repetitions
+			<< ", \"median_ns\": " << result.median
+			<< ", \"p95_ns\": " << result.p95
+			<< ", \"mean_ns\": " << result.mean
+			<< ", \"stddev_ns\": " << result.stddev
+			<< ", \"min_ns\": " << result.min
+			<< ", \"max_ns\": " << result.max << '}';
+		out << (i + 1 < (int)results.size() ? "," : "") << endl;
+	}
+	out << ']' << endl;
+	out << defaultfloat;
+}
+
+void sort_benchmark::write_json_string(ostream& out, const string& str)
+{
+	out << '"';
+	for(char c : str)
+	{
+		if(c == '"' || c == '\\')
+		{
+			out << '\\';
+		}
+		out << c;
+	}
+	out << '"';
+}
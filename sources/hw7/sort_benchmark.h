@@ -0,0 +1,93 @@
+/*
+ * sort_benchmark.h
+ *
+ * Times a sorter over many repetitions on fresh copies of the same input,
+ * after a few untimed warm-up runs, and summarizes the times. Results can
+ * be written as CSV or JSON so runs can be compared across releases
+ */
+
+#ifndef SORT_BENCHMARK_H_
+#define SORT_BENCHMARK_H_
+
+#include "sorter.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Summary of the times of one sorter on one input, all in nanoseconds
+struct benchmark_result
+{
+	std::string input;	// Name of the input that was sorted
+	std::string sortType;	// Name of the sort
+	int count;	// Elements sorted
+	int repetitions;	// Timed runs the statistics are taken over
+	double median;
+	double p95;
+	double mean;
+	double stddev;
+	double min;
+	double max;
+};
+
+class sort_benchmark
+{
+// PRIVATE DATA
+private:
+	int warmups;	// Untimed runs before the timed ones
+	int repetitions;	// Timed runs
+	std::vector<benchmark_result> results;	// Results of every run so far
+
+// PUBLIC INTERFACE
+public:
+	sort_benchmark(int warmups, int repetitions);
+
+	// Sort the first count elements of the data with the sorter, warmups
+	// times untimed and repetitions times timed, each time starting from
+	// a fresh copy of the data. Return the statistics and keep them
+	template<typename Type>
+	const benchmark_result& run(sorter<Type>& sort, const std::string& input, const Type* data, int count);
+
+	// All results so far
+	const std::vector<benchmark_result>& get_results() const { return results; }
+
+	// Output one line per result to the console
+	static void print_report(std::ostream& out, const benchmark_result& result);
+
+	// Output all results so far as CSV with a header row
+	void write_csv(std::ostream& out) const;
+
+	// Output all results so far as a JSON array of objects
+	void write_json(std::ostream& out) const;
+
+// PRIVATE UTILITIES
+private:
+	// Summarize the times and keep the result
+	const benchmark_result& add_result(const std::string& input, const std::string& sortType,
+			int count, std::vector<double>& times);
+
+	// Output the string as a quoted JSON string
+	static void write_json_string(std::ostream& out, const std::string& str);
+};
+
+template<typename Type>
+const benchmark_result& sort_benchmark::run(sorter<Type>& sort, const std::string& input, const Type* data, int count)
+{
+	for(int i = 0; i < warmups; i++)
+	{
+		sort.initialize_from_data(data, count);
+		sort.sort();
+	}
+
+	std::vector<double> times;
+	times.reserve(repetitions);
+	for(int i = 0; i < repetitions; i++)
+	{
+		sort.initialize_from_data(data, count);
+		times.push_back(sort.timed_sort().count());
+	}
+
+	return add_result(input, sort.get_name(), count, times);
+}
+
+#endif /* SORT_BENCHMARK_H_ */
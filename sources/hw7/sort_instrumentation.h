@@ -0,0 +1,130 @@
+/*
+ * sort_instrumentation.h
+ *
+ * Opt-in operation counting for the sorters. Sorting counted<Type>
+ * instead of Type counts every comparison, copy and move the sorter
+ * makes, and the recursion_guard each recursive sort function holds
+ * tracks how deep it went. For any other element type the guard is
+ * empty and the counters are never touched, so nothing is added
+ */
+
+#ifndef SORT_INSTRUMENTATION_H_
+#define SORT_INSTRUMENTATION_H_
+
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Operation counts shared by every counted element. Counted from any thread
+struct sort_counters
+{
+	static inline std::atomic<long long> comparisons{0};
+	static inline std::atomic<long long> copies{0};
+	static inline std::atomic<long long> moves{0};
+	static inline std::atomic<int> maxDepth{0};
+	// Recursion depth of the sort running on this thread
+	static inline thread_local int depth = 0;
+
+	// Set every count back to zero
+	static void reset()
+	{
+		comparisons = 0;
+		copies = 0;
+		moves = 0;
+		maxDepth = 0;
+	}
+
+	// Counts as a note for a sort report
+	static std::string summary()
+	{
+		std::ostringstream out;
+		out << comparisons << " comparisons, " << copies << " copies, "
+			<< moves << " moves, depth " << maxDepth;
+		return out.str();
+	}
+
+	static void count(std::atomic<long long>& counter)
+	{
+		counter.fetch_add(1, std::memory_order_relaxed);
+	}
+};
+
+// Element that behaves like the value it holds, but counts what is done to it
+template<typename Type>
+class counted
+{
+private:
+	Type value;
+
+public:
+	counted() : value() {}
+	counted(const Type& value) : value(value) {}
+
+	counted(const counted& other) : value(other.value) { sort_counters::count(sort_counters::copies); }
+	counted(counted&& other) : value(std::move(other.value)) { sort_counters::count(sort_counters::moves); }
+
+	counted& operator=(const counted& other)
+	{
+		sort_counters::count(sort_counters::copies);
+		value = other.value;
+		return *this;
+	}
+
+	counted& operator=(counted&& other)
+	{
+		sort_counters::count(sort_counters::moves);
+		value = std::move(other.value);
+		return *this;
+	}
+
+	const Type& get() const { return value; }
+
+	friend bool operator<(const counted& a, const counted& b)
+	{
+		sort_counters::count(sort_counters::comparisons);
+		return a.value < b.value;
+	}
+
+	friend bool operator>(const counted& a, const counted& b)
+	{
+		return b < a;
+	}
+
+	friend std::ostream& operator<<(std::ostream& out, const counted& element)
+	{
+		return out << element.value;
+	}
+};
+
+// Is the type counted<...>, in which case sorts of it are instrumented
+template<typename Type>
+struct is_counted : std::false_type {};
+
+template<typename Type>
+struct is_counted<counted<Type>> : std::true_type {};
+
+// Held for the duration of each call of a recursive sort function.
+// Empty unless the elements are counted
+template<typename Type, bool = is_counted<Type>::value>
+struct recursion_guard
+{
+	recursion_guard() {}
+};
+
+template<typename Type>
+struct recursion_guard<Type, true>
+{
+	recursion_guard()
+	{
+		int depth = ++sort_counters::depth;
+		int deepest = sort_counters::maxDepth.load(std::memory_order_relaxed);
+		while(depth > deepest && !sort_counters::maxDepth.compare_exchange_weak(deepest, depth)) {}
+	}
+
+	~recursion_guard() { sort_counters::depth--; }
+};
+
+#endif /* SORT_INSTRUMENTATION_H_ */
@@ -0,0 +1,157 @@
+/*
+ * sort_kernels.h
+ *
+ * The in-place building blocks the comparison sorts share: insertion
+ * sort for small ranges, the median-of-three/ninther pivot choice, the
+ * Hoare partition and the depth budget after which introsort gives up
+ * on quicksort. They depend on nothing but the order, so the sorter
+ * base class helpers can use them without knowing about any sorter
+ */
+
+#ifndef SORT_KERNELS_H_
+#define SORT_KERNELS_H_
+
+#include "sort_order.h"
+#include <utility>
+
+// INTERFACE
+
+template<typename Type>
+class sort_kernels
+{
+public:
+	// Insertion sort the part [start, end) of the given array in place
+	template<typename Order = default_order>
+	static void insertion_sort(Type* array, int start, int end, Order less = Order());
+
+	// Levels of partitioning allowed on a range of the given length
+	// before giving up on quicksort: 2 * floor(log2(length))
+	static int depth_budget(int length);
+
+	// Move the pivot at pivotIndex to the start, partition the range
+	// around it and return the final index of the pivot
+	template<typename Order = default_order>
+	static int partition(Type* array, int start, int end, int pivotIndex, Order less = Order());
+
+	// Return the index of the pivot to use for the range [start, end):
+	// the median of three, or Tukey's ninther for big ranges
+	template<typename Order = default_order>
+	static int choose_pivot(Type* array, int start, int end, Order less = Order());
+
+private:
+	// Ranges bigger than this use the ninther instead of median-of-three
+	static const int NINTHER_CUTOFF = 128;
+
+	// Return the index of the median of the three elements at the given indices
+	template<typename Order>
+	static int median_of_three(Type* array, int a, int b, int c, Order less);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+template<typename Order>
+void sort_kernels<Type>::insertion_sort(Type* array, int start, int end, Order less)
+{
+	for(int i = start + 1; i < end; i++)
+	{
+		// Shift bigger elements up until the slot for the current value is found
+		Type value = std::move(array[i]);
+		int insertionIndex = i;
+
+		while(insertionIndex > start && less(value, array[insertionIndex - 1]))
+		{
+			array[insertionIndex] = std::move(array[insertionIndex - 1]);
+			insertionIndex--;
+		}
+
+		array[insertionIndex] = std::move(value);
+	}
+}
+
+template<typename Type>
+int sort_kernels<Type>::depth_budget(int length)
+{
+	int depthBudget = 0;
+	for(int n = length; n > 1; n >>= 1)
+	{
+		depthBudget += 2;
+	}
+	return depthBudget;
+}
+
+template<typename Type>
+template<typename Order>
+int sort_kernels<Type>::partition(Type* array, int start, int end, int pivotIndex, Order less)
+{
+	// Park the pivot at the start of the range
+	std::swap(array[start], array[pivotIndex]);
+
+	// Hoare partition: both scans stop on keys equal to the pivot,
+	// so runs of duplicates still split down the middle
+	int low = start;
+	int high = end;
+	while(true)
+	{
+		do { low++; } while(low < end && less(array[low], array[start]));
+		do { high--; } while(less(array[start], array[high]));
+
+		if(low >= high)
+		{
+			break;
+		}
+		std::swap(array[low], array[high]);
+	}
+
+	// Put the pivot between the two halves
+	std::swap(array[start], array[high]);
+
+	return high;
+}
+
+template<typename Type>
+template<typename Order>
+int sort_kernels<Type>::median_of_three(Type* array, int a, int b, int c, Order less)
+{
+	if(less(array[a], array[b]))
+	{
+		if(less(array[b], array[c]))
+		{
+			return b;
+		}
+		return less(array[a], array[c]) ? c : a;
+	}
+	else
+	{
+		if(less(array[a], array[c]))
+		{
+			return a;
+		}
+		return less(array[b], array[c]) ? c : b;
+	}
+}
+
+template<typename Type>
+template<typename Order>
+int sort_kernels<Type>::choose_pivot(Type* array, int start, int end, Order less)
+{
+	int length = end - start;
+	int middle = start + length / 2;
+	int last = end - 1;
+
+	if(length > NINTHER_CUTOFF)
+	{
+		// Tukey's ninther: the median of the medians of three spread out triples
+		int step = length / 8;
+		int low = median_of_three(array, start, start + step, start + 2 * step, less);
+		int mid = median_of_three(array, middle - step, middle, middle + step, less);
+		int high = median_of_three(array, last - 2 * step, last - step, last, less);
+		return median_of_three(array, low, mid, high, less);
+	}
+	else
+	{
+		return median_of_three(array, start, middle, last, less);
+	}
+}
+
+#endif /* SORT_KERNELS_H_ */
@@ -0,0 +1,37 @@
+/*
+ * sort_order.h
+ *
+ * Ordering policies for the sort kernels. A sort_order compares the keys
+ * KeyFn extracts with Compare. Both are empty types known at compile
+ * time, so every comparison inlines down to the key access and the
+ * compare itself
+ */
+
+#ifndef SORT_ORDER_H_
+#define SORT_ORDER_H_
+
+#include <functional>
+#include <utility>
+
+// Key extractor that uses the element itself as its key
+struct identity_key
+{
+	template<typename Type>
+	const Type& operator()(const Type& element) const { return element; }
+};
+
+template<typename Compare = std::less<>, typename KeyFn = identity_key>
+struct sort_order
+{
+	// Return true if a goes before b
+	template<typename Type>
+	bool operator()(const Type& a, const Type& b) const
+	{
+		return Compare()(KeyFn()(a), KeyFn()(b));
+	}
+};
+
+// The order operator< gives, which every sorter uses by default
+typedef std::less<> default_order;
+
+#endif /* SORT_ORDER_H_ */
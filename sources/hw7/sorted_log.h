@@ -0,0 +1,196 @@
+/*
+ * SORTED LOG: Time complexity - O(logn) amortized insert, O(log^2 n) lookup
+ *
+ * Collection that stays sorted while values keep coming in, without ever
+ * sorting everything again. New values go to an unsorted tail; a full
+ * tail is sorted and merged into levels of sorted runs, where level i
+ * holds either nothing or a run of tailCapacity * 2^i values, the way a
+ * binary counter carries. Every value is merged about log(n) times
+ */
+
+#ifndef SORTED_LOG_H_
+#define SORTED_LOG_H_
+
+#include "intro_sorter.h"
+#include "loser_tree.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class sorted_log
+{
+public:
+	// Values the tail holds before it is sorted into the levels
+	static const int DEFAULT_TAIL_CAPACITY = 1024;
+
+	sorted_log(int tailCapacity = DEFAULT_TAIL_CAPACITY) :
+		tailCapacity(std::max(1, tailCapacity)), totalSize(0) {}
+
+	// Add a value
+	void insert(const Type& value);
+
+	// Return true if a value equal to the key has been inserted
+	bool contains(const Type& key) const;
+
+	// Number of inserted values equal to the key
+	int count(const Type& key) const;
+
+	// Number of values inserted
+	int size() const { return totalSize; }
+
+	// Number of levels of sorted runs, including empty ones
+	int level_count() const { return levels.size(); }
+
+	// All values inserted so far, in order
+	std::vector<Type> sorted() const;
+
+	// Sort the tail into the levels now instead of waiting for it to fill
+	void flush();
+
+private:
+	int tailCapacity;
+	int totalSize;
+	// Values inserted since the last flush, in insertion order
+	std::vector<Type> tail;
+	// Sorted runs, levels[i] is empty or about tailCapacity * 2^i long
+	std::vector<std::vector<Type>> levels;
+
+	// Merge the sorted run into the levels, carrying into the next level
+	// for as long as the level it lands on is taken
+	void carry(std::vector<Type> run);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+void sorted_log<Type>::insert(const Type& value)
+{
+	tail.push_back(value);
+	totalSize++;
+
+	if((int)tail.size() >= tailCapacity)
+	{
+		flush();
+	}
+}
+
+template<typename Type>
+void sorted_log<Type>::flush()
+{
+	if(tail.empty())
+	{
+		return;
+	}
+
+	std::vector<Type> run;
+	run.swap(tail);
+	intro_sorter<Type>::intro_sort(run.data(), 0, run.size());
+	carry(std::move(run));
+}
+
+template<typename Type>
+void sorted_log<Type>::carry(std::vector<Type> run)
+{
+	int level = 0;
+	while(level < (int)levels.size() && !levels[level].empty())
+	{
+		// Merge with the run already on this level and move up
+		std::vector<Type> merged;
+		merged.reserve(run.size() + levels[level].size());
+		std::merge(std::make_move_iterator(levels[level].begin()), std::make_move_iterator(levels[level].end()),
+				std::make_move_iterator(run.begin()), std::make_move_iterator(run.end()),
+				std::back_inserter(merged));
+
+		levels[level].clear();
+		levels[level].shrink_to_fit();
+		run.swap(merged);
+		level++;
+	}
+
+	if(level == (int)levels.size())
+	{
+		levels.emplace_back();
+	}
+	levels[level] = std::move(run);
+}
+
+template<typename Type>
+bool sorted_log<Type>::contains(const Type& key) const
+{
+	for(const std::vector<Type>& level : levels)
+	{
+		if(std::binary_search(level.begin(), level.end(), key))
+		{
+			return true;
+		}
+	}
+
+	// The tail is short and unsorted, so scan it
+	for(const Type& value : tail)
+	{
+		if(!(value < key) && !(key < value))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename Type>
+int sorted_log<Type>::count(const Type& key) const
+{
+	int total = 0;
+	for(const std::vector<Type>& level : levels)
+	{
+		auto range = std::equal_range(level.begin(), level.end(), key);
+		total += range.second - range.first;
+	}
+	for(const Type& value : tail)
+	{
+		if(!(value < key) && !(key < value))
+		{
+			total++;
+		}
+	}
+	return total;
+}
+
+template<typename Type>
+std::vector<Type> sorted_log<Type>::sorted() const
+{
+	// The sorted tail counts as one more run
+	std::vector<Type> sortedTail(tail);
+	intro_sorter<Type>::intro_sort(sortedTail.data(), 0, sortedTail.size());
+
+	std::vector<const std::vector<Type>*> runs;
+	for(const std::vector<Type>& level : levels)
+	{
+		runs.push_back(&level);
+	}
+	runs.push_back(&sortedTail);
+
+	// Merge all runs at once with a loser tree
+	loser_tree<Type> tree(runs.size());
+	std::vector<int> next(runs.size(), 0);
+	for(int run = 0; run < (int)runs.size(); run++)
+	{
+		tree.set_head(run, runs[run]->empty() ? nullptr : runs[run]->data());
+	}
+	tree.build();
+
+	std::vector<Type> result;
+	result.reserve(totalSize);
+	while(!tree.empty())
+	{
+		int run = tree.winner();
+		result.push_back(tree.winner_head());
+		next[run]++;
+		tree.replace_winner(next[run] < (int)runs[run]->size() ? runs[run]->data() + next[run] : nullptr);
+	}
+	return result;
+}
+
+#endif /* SORTED_LOG_H_ */
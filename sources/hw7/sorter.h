@@ -14,7 +14,16 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <stdexcept>
 #include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "sort_instrumentation.h"
+#include "perf_counters.h"
+#include "selector.h"
+#include "unique_merger.h"
 
 // INTERFACE
 
@@ -31,8 +40,9 @@ public:
 	// Initialize the sorter with the given capacity of objects in its array
 	sorter(int capacity);
 
-	// Sort the list and return the number of seconds it took to complete
-	std::chrono::milliseconds timed_sort();
+	// Sort the list and return the time it took to complete,
+	// measured on the steady clock so clock adjustments never show up
+	std::chrono::nanoseconds timed_sort();
 
 	// Sort the list using operator<
 	virtual void sort() = 0;
@@ -40,18 +50,77 @@ public:
 	// Sort the list and report the time it took
 	virtual void sort_report() = 0;
 
+	// Name of the sort used in reports
+	virtual std::string get_name() const = 0;
+
 	// Print the list
 	void print(std::ostream& out) const;
 
+	// Return the element a full sort would put at index k, moving it there
+	// with nothing bigger before it and nothing smaller after it. O(n)
+	const Type& select(int k);
+
+	// Sort only the k smallest elements into the first k positions
+	void partial_sort(int k);
+
+	// Return the k smallest values of the stream in order, without
+	// ever loading the whole stream
+	static std::vector<Type> top_k(std::istream& in, int k);
+
+	// Sort the list and drop duplicates while merging, leaving only the
+	// distinct elements in the list. Return how many there are
+	int sort_unique();
+
+	// Same as sort_unique, but return each distinct element with the
+	// number of times it came up
+	std::vector<std::pair<Type, int>> sort_count();
+
 	// Initialize all elements in the array from the file with the given name
 	void initialize_from_file(const char* filename, int numToLoad);
 
+	// Initialize the array with a copy of the first elements of already loaded data
+	void initialize_from_data(const Type* data, int numToLoad);
+
+	// Make the first numToLoad elements of the array the ones to sort and return
+	// the array, so the caller can build them in place instead of copying them in.
+	// Return nullptr if they do not fit
+	Type* initialize_in_place(int numToLoad);
+
+	// Initialize the array from the next elements of the stream, stopping at the
+	// capacity, at the end of the stream or once the elements own maxBytes of
+	// memory outside the array. Return the number of elements loaded
+	int initialize_from_stream(std::istream& in, size_t maxBytes);
+
+	// Elements of the array, the first get_length() of them are initialized
+	const Type* get_array() const { return array; }
+	int get_length() const { return arrayLen; }
+
 	virtual ~sorter() { delete [] array; }
 
 protected:
 	// Sort the list and output the time it took to the console
 	void sort_report(std::string sortType);
 
+	// Sort the list and return the time it took. If the elements are
+	// counted, note gets the operation and hardware counts of the sort
+	std::chrono::nanoseconds instrumented_sort(std::string& note);
+
+	// Return true if sorting the current elements runs work on other threads.
+	// Hardware counters only see the calling thread, so these sorts report none
+	virtual bool sorts_in_parallel() const { return false; }
+
+	// Reorder the array so that position i gets the element that was at
+	// position source[i]. Follows each cycle once, so every element moves once.
+	// Entries of source are overwritten
+	void apply_permutation(std::vector<int>& source);
+
+	// Bytes the element owns outside of the array
+	static size_t owned_bytes(const Type& element);
+
+	// Output one line of a sort report for a sort that took the given time
+	static void print_report(std::ostream& out, const std::string& sortType,
+			std::chrono::nanoseconds time, const std::string& note = "");
+
 	template<typename SType>
 	friend std::ostream& operator<<(std::ostream& out, const sorter<SType>&);
 };
@@ -67,21 +136,84 @@ sorter<Type>::sorter(int capacity)
 }
 
 template<typename Type>
-std::chrono::milliseconds sorter<Type>::timed_sort()
+std::chrono::nanoseconds sorter<Type>::timed_sort()
 {
-	auto begin = std::chrono::system_clock::now();
+	auto begin = std::chrono::steady_clock::now();
 	sort();
-	auto end = std::chrono::system_clock::now();
-	return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
 }
 
 template<typename Type>
 void sorter<Type>::sort_report(std::string sortType)
 {
-	// Output the result
-	std::cout << std::setfill('-') << std::left;
-	std::cout << std::setw(23) << (sortType + ":") << ">: completed in " << timed_sort().count() << " milliseconds" << std::endl;
-	std::cout << std::setfill(' ') << std::right;
+	std::string note;
+	auto time = instrumented_sort(note);
+	print_report(std::cout, sortType, time, note);
+}
+
+template<typename Type>
+std::chrono::nanoseconds sorter<Type>::instrumented_sort(std::string& note)
+{
+	if constexpr(is_counted<Type>::value)
+	{
+		perf_counters hardware;
+		sort_counters::reset();
+		hardware.start();
+		auto time = timed_sort();
+		hardware.stop();
+
+		std::string hardwareSummary = sorts_in_parallel() ? "" : hardware.summary();
+		note = sort_counters::summary() + (hardwareSummary.empty() ? "" : ", " + hardwareSummary);
+		return time;
+	}
+	else
+	{
+		return timed_sort();
+	}
+}
+
+template<typename Type>
+void sorter<Type>::print_report(std::ostream& out, const std::string& sortType,
+		std::chrono::nanoseconds time, const std::string& note)
+{
+	// Output the result, with fractions of a millisecond so short sorts don't show up as 0
+	out << std::setfill('-') << std::left;
+	out << std::setw(23) << (sortType + ":") << ">: completed in " << std::fixed << std::setprecision(3)
+		<< std::chrono::duration<double, std::milli>(time).count() << " milliseconds";
+	out << std::setfill(' ') << std::right << std::defaultfloat;
+
+	if(!note.empty())
+	{
+		out << " (" << note << ")";
+	}
+	out << std::endl;
+}
+
+template<typename Type>
+void sorter<Type>::apply_permutation(std::vector<int>& source)
+{
+	for(int start = 0; start < (int)source.size(); start++)
+	{
+		// Skip positions that were already filled by an earlier cycle
+		if(source[start] == start)
+		{
+			continue;
+		}
+
+		// Rotate the cycle through the start position
+		Type held = std::move(array[start]);
+		int current = start;
+		while(source[current] != start)
+		{
+			int next = source[current];
+			array[current] = std::move(array[next]);
+			source[current] = current;
+			current = next;
+		}
+		array[current] = std::move(held);
+		source[current] = current;
+	}
 }
 
 template<typename Type>
@@ -94,6 +226,53 @@ void sorter<Type>::print(std::ostream& out) const
 	}
 }
 
+template<typename Type>
+const Type& sorter<Type>::select(int k)
+{
+	if(k < 0 || k >= arrayLen)
+	{
+		throw std::out_of_range("For input " + std::to_string(k) + ": index is not in the array");
+	}
+
+	selector<Type>::select(array, arrayLen, k);
+	return array[k];
+}
+
+template<typename Type>
+void sorter<Type>::partial_sort(int k)
+{
+	selector<Type>::partial_sort(array, arrayLen, k);
+}
+
+template<typename Type>
+std::vector<Type> sorter<Type>::top_k(std::istream& in, int k)
+{
+	return selector<Type>::top_k(in, k);
+}
+
+template<typename Type>
+int sorter<Type>::sort_unique()
+{
+	std::vector<int> counts(arrayLen);
+	arrayLen = unique_merger<Type>::sort_count(array, counts.data(), arrayLen);
+	return arrayLen;
+}
+
+template<typename Type>
+std::vector<std::pair<Type, int>> sorter<Type>::sort_count()
+{
+	std::vector<int> counts(arrayLen);
+	arrayLen = unique_merger<Type>::sort_count(array, counts.data(), arrayLen);
+
+	std::vector<std::pair<Type, int>> keyCounts;
+	keyCounts.reserve(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		keyCounts.emplace_back(array[i], counts[i]);
+	}
+	return keyCounts;
+}
+
 template<typename Type>
 std::ostream& operator<<(std::ostream& out, const sorter<Type>& sort)
 {
@@ -119,5 +298,51 @@ void sorter<Type>::initialize_from_file(const char* filename, int numToLoad)
 	}
 }
 
+template<typename Type>
+void sorter<Type>::initialize_from_data(const Type* data, int numToLoad)
+{
+	if(numToLoad <= arrayCapacity)
+	{
+		std::copy(data, data + numToLoad, array);
+		arrayLen = numToLoad;
+	}
+}
+
+template<typename Type>
+Type* sorter<Type>::initialize_in_place(int numToLoad)
+{
+	if(numToLoad > arrayCapacity)
+	{
+		return nullptr;
+	}
+	arrayLen = numToLoad;
+	return array;
+}
+
+template<typename Type>
+int sorter<Type>::initialize_from_stream(std::istream& in, size_t maxBytes)
+{
+	size_t bytes = 0;
+	arrayLen = 0;
+	while(arrayLen < arrayCapacity && bytes < maxBytes && in >> array[arrayLen])
+	{
+		bytes += owned_bytes(array[arrayLen]);
+		arrayLen++;
+	}
+	return arrayLen;
+}
+
+template<typename Type>
+size_t sorter<Type>::owned_bytes(const Type& element)
+{
+	if constexpr(std::is_same<Type, std::string>::value)
+	{
+		return element.capacity();
+	}
+	else
+	{
+		return 0;
+	}
+}
 
 #endif /* SORTER_H_ */
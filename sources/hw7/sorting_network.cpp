@@ -0,0 +1,277 @@
+/*
+ * sorting_network.cpp
+ */
+
+#include "sorting_network.h"
+#include "insertion_sorter.h"
+#include <limits>
+using namespace std;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORTING_NETWORK_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef SORTING_NETWORK_AVX2
+
+// Everything the network does on a register of a given element type.
+// Lane permutations and blend masks are passed as 32-bit lane vectors
+// so both element types use the same tables
+struct int_lanes
+{
+	typedef int element;
+	typedef __m256i vec;
+	static const int LANES = 8;
+
+	__attribute__((target("avx2"))) static vec load(const int* from) { return _mm256_loadu_si256((const __m256i*)from); }
+	__attribute__((target("avx2"))) static void store(int* to, vec v) { _mm256_storeu_si256((__m256i*)to, v); }
+	__attribute__((target("avx2"))) static vec min(vec a, vec b) { return _mm256_min_epi32(a, b); }
+	__attribute__((target("avx2"))) static vec max(vec a, vec b) { return _mm256_max_epi32(a, b); }
+	__attribute__((target("avx2"))) static vec permute(vec v, __m256i index) { return _mm256_permutevar8x32_epi32(v, index); }
+	__attribute__((target("avx2"))) static vec blend(vec a, vec b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+};
+
+struct double_lanes
+{
+	typedef double element;
+	typedef __m256d vec;
+	static const int LANES = 4;
+
+	__attribute__((target("avx2"))) static vec load(const double* from) { return _mm256_loadu_pd(from); }
+	__attribute__((target("avx2"))) static void store(double* to, vec v) { _mm256_storeu_pd(to, v); }
+	__attribute__((target("avx2"))) static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+	__attribute__((target("avx2"))) static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+	__attribute__((target("avx2"))) static vec permute(vec v, __m256i index)
+	{
+		// Move each double as its two 32-bit halves
+		return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), index));
+	}
+	__attribute__((target("avx2"))) static vec blend(vec a, vec b, __m256i mask)
+	{
+		return _mm256_blendv_pd(a, b, _mm256_castsi256_pd(mask));
+	}
+};
+
+// One compare-exchange step between the lanes of a register: every lane
+// is compared with lane (lane ^ distance) and keeps the min or the max
+struct lane_stage
+{
+	alignas(32) int partner[8];	// 32-bit lane each 32-bit lane reads from
+	alignas(32) int takeMax[8];	// -1 on 32-bit lanes that keep the max
+};
+
+// Stages of a full bitonic sort and of a bitonic merge within one register
+template<int Lanes>
+struct lane_network
+{
+	// Sorting a register takes log(L)(log(L) + 1) / 2 stages, merging log(L)
+	lane_stage sortStages[6];
+	lane_stage mergeStages[3];
+	int sortStageCount;
+	int mergeStageCount;
+	// 32-bit lane indices that reverse the order of the elements
+	alignas(32) int reverse[8];
+
+	lane_network() : sortStageCount(0), mergeStageCount(0)
+	{
+		const int WIDTH = 8 / Lanes;	// 32-bit lanes per element
+		for(int size = 2; size <= Lanes; size *= 2)
+		{
+			for(int distance = size / 2; distance > 0; distance /= 2)
+			{
+				// Runs of the given size alternate between ascending and
+				// descending so each pair of them forms a bitonic sequence
+				fill(sortStages[sortStageCount++], distance, [size, distance](int lane) {
+					return ((lane & distance) != 0) == ((lane & size) == 0);
+				});
+			}
+		}
+		for(int distance = Lanes / 2; distance > 0; distance /= 2)
+		{
+			fill(mergeStages[mergeStageCount++], distance, [distance](int lane) {
+				return (lane & distance) != 0;
+			});
+		}
+		for(int i = 0; i < 8; i++)
+		{
+			reverse[i] = (Lanes - 1 - i / WIDTH) * WIDTH + i % WIDTH;
+		}
+	}
+
+	template<typename TakeMax>
+	static void fill(lane_stage& stage, int distance, TakeMax takeMax)
+	{
+		const int WIDTH = 8 / Lanes;
+		for(int i = 0; i < 8; i++)
+		{
+			int lane = i / WIDTH;
+			stage.partner[i] = (lane ^ distance) * WIDTH + i % WIDTH;
+			stage.takeMax[i] = takeMax(lane) ? -1 : 0;
+		}
+	}
+};
+
+template<typename Lanes>
+class vector_network
+{
+private:
+	typedef typename Lanes::element element;
+	typedef typename Lanes::vec vec;
+	static const int LANES = Lanes::LANES;
+	static const int MAX_REGISTERS = sorting_network::MAX_BLOCK / LANES;
+
+	static const lane_network<LANES>& network()
+	{
+		static const lane_network<LANES> tables;
+		return tables;
+	}
+
+	__attribute__((target("avx2"))) static vec apply(vec v, const lane_stage& stage)
+	{
+		vec other = Lanes::permute(v, _mm256_load_si256((const __m256i*)stage.partner));
+		return Lanes::blend(Lanes::min(v, other), Lanes::max(v, other),
+				_mm256_load_si256((const __m256i*)stage.takeMax));
+	}
+
+	__attribute__((target("avx2"))) static vec reverse(vec v)
+	{
+		return Lanes::permute(v, _mm256_load_si256((const __m256i*)network().reverse));
+	}
+
+	// Sort the lanes of one register
+	__attribute__((target("avx2"))) static vec sort_lanes(vec v)
+	{
+		const lane_network<LANES>& tables = network();
+		for(int stage = 0; stage < tables.sortStageCount; stage++)
+		{
+			v = apply(v, tables.sortStages[stage]);
+		}
+		return v;
+	}
+
+	// Sort the lanes of one register that hold a bitonic sequence
+	__attribute__((target("avx2"))) static vec merge_lanes(vec v)
+	{
+		const lane_network<LANES>& tables = network();
+		for(int stage = 0; stage < tables.mergeStageCount; stage++)
+		{
+			v = apply(v, tables.mergeStages[stage]);
+		}
+		return v;
+	}
+
+	// Merge the sorted registers [0, width) with the sorted registers [width, 2 * width)
+	__attribute__((target("avx2"))) static void merge_registers(vec* regs, int width)
+	{
+		// Reversing the second half makes the whole group bitonic, then one
+		// compare-exchange puts every small element in the first half
+		for(int i = 0; i < width; i++)
+		{
+			vec low = regs[i];
+			vec high = reverse(regs[2 * width - 1 - i]);
+			regs[i] = Lanes::min(low, high);
+			regs[2 * width - 1 - i] = Lanes::max(low, high);
+		}
+		// Put the second half back in register order, it's bitonic either way
+		for(int i = 0; i < width / 2; i++)
+		{
+			swap(regs[width + i], regs[2 * width - 1 - i]);
+		}
+
+		// Both halves are bitonic, so half-clean them down to single registers
+		for(int distance = width / 2; distance > 0; distance /= 2)
+		{
+			for(int i = 0; i < 2 * width; i++)
+			{
+				if((i & distance) == 0)
+				{
+					vec low = regs[i];
+					regs[i] = Lanes::min(low, regs[i + distance]);
+					regs[i + distance] = Lanes::max(low, regs[i + distance]);
+				}
+			}
+		}
+		for(int i = 0; i < 2 * width; i++)
+		{
+			regs[i] = merge_lanes(regs[i]);
+		}
+	}
+
+public:
+	__attribute__((target("avx2"))) static void sort(element* array, int length)
+	{
+		// Pad the block to a power of two registers with the biggest value
+		int registers = 1;
+		while(registers * LANES < length)
+		{
+			registers *= 2;
+		}
+
+		alignas(32) element padded[sorting_network::MAX_BLOCK];
+		copy(array, array + length, padded);
+		fill(padded + length, padded + registers * LANES, numeric_limits<element>::has_infinity ?
+				numeric_limits<element>::infinity() : numeric_limits<element>::max());
+
+		vec regs[MAX_REGISTERS];
+		for(int i = 0; i < registers; i++)
+		{
+			regs[i] = sort_lanes(Lanes::load(padded + i * LANES));
+		}
+		for(int width = 1; width < registers; width *= 2)
+		{
+			for(int group = 0; group < registers; group += 2 * width)
+			{
+				merge_registers(regs + group, width);
+			}
+		}
+		for(int i = 0; i < registers; i++)
+		{
+			Lanes::store(padded + i * LANES, regs[i]);
+		}
+
+		copy(padded, padded + length, array);
+	}
+};
+
+#endif /* SORTING_NETWORK_AVX2 */
+
+bool sorting_network::vectorized()
+{
+#ifdef SORTING_NETWORK_AVX2
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+void sorting_network::sort(int* array, int length)
+{
+#ifdef SORTING_NETWORK_AVX2
+	if(vectorized() && length > 1 && length <= MAX_BLOCK)
+	{
+		vector_network<int_lanes>::sort(array, length);
+		return;
+	}
+#endif
+	insertion_sorter<int>::insertion_sort(array, 0, length);
+}
+
+void sorting_network::sort(double* array, int length)
+{
+#ifdef SORTING_NETWORK_AVX2
+	// Vector min and max don't order NaNs the way operator< does
+	bool hasNaN = false;
+	for(int i = 0; i < length; i++)
+	{
+		hasNaN |= array[i] != array[i];
+	}
+
+	if(vectorized() && !hasNaN && length > 1 && length <= MAX_BLOCK)
+	{
+		vector_network<double_lanes>::sort(array, length);
+		return;
+	}
+#endif
+	insertion_sorter<double>::insertion_sort(array, 0, length);
+}
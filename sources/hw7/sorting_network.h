@@ -0,0 +1,35 @@
+/*
+ * sorting_network.h
+ *
+ * Branch-free base case for sorts of ints and doubles. Blocks of up to
+ * MAX_BLOCK elements are loaded into AVX2 registers, each register is
+ * sorted with a bitonic network across its lanes, and the registers are
+ * then bitonic merged together. CPUs without AVX2 get insertion sort
+ */
+
+#ifndef SORTING_NETWORK_H_
+#define SORTING_NETWORK_H_
+
+#include <type_traits>
+
+class sorting_network
+{
+// PUBLIC INTERFACE
+public:
+	// Largest block sort() can handle
+	static const int MAX_BLOCK = 64;
+
+	// True for the element types the network can sort
+	template<typename Type>
+	struct supports : std::integral_constant<bool,
+		std::is_same<Type, int>::value || std::is_same<Type, double>::value> {};
+
+	// Sort the given array of at most MAX_BLOCK elements in place
+	static void sort(int* array, int length);
+	static void sort(double* array, int length);
+
+	// Return true if this CPU runs the vector network
+	static bool vectorized();
+};
+
+#endif /* SORTING_NETWORK_H_ */
@@ -0,0 +1,152 @@
+/*
+ * string_radix_sorter.cpp
+ */
+
+#include "string_radix_sorter.h"
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+void string_radix_sorter::sort()
+{
+	// Sort small keys that point into the strings, then move
+	// each string to its sorted position once at the end
+	keys.resize(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		keys[i] = radix_key { array[i].data(), (int)array[i].size(), i };
+	}
+
+	radix_sort(keys.data(), arrayLen);
+
+	vector<int> source(arrayLen);
+	for(int i = 0; i < arrayLen; i++)
+	{
+		source[i] = keys[i].index;
+	}
+	apply_permutation(source);
+}
+
+void string_radix_sorter::sort_report()
+{
+	sorter<string>::sort_report(get_name());
+}
+
+void string_radix_sorter::radix_sort(radix_key* keys, int count)
+{
+	vector<radix_key> scratch(count);
+	msd_radix_sort(keys, scratch.data(), count, 0);
+}
+
+void string_radix_sorter::msd_radix_sort(radix_key* keys, radix_key* scratch, int count, int depth)
+{
+	if(count < MULTIKEY_CUTOFF)
+	{
+		multikey_quicksort(keys, count, depth);
+		return;
+	}
+
+	// Count the keys going into each bucket
+	int bucketStart[TOTAL_BUCKETS + 1] = {};
+	for(int i = 0; i < count; i++)
+	{
+		bucketStart[bucket_at(keys[i], depth) + 1]++;
+	}
+	for(int bucket = 0; bucket < TOTAL_BUCKETS; bucket++)
+	{
+		bucketStart[bucket + 1] += bucketStart[bucket];
+	}
+
+	// Scatter the keys into their buckets and copy them back in order
+	int next[TOTAL_BUCKETS];
+	copy(bucketStart, bucketStart + TOTAL_BUCKETS, next);
+	for(int i = 0; i < count; i++)
+	{
+		scratch[next[bucket_at(keys[i], depth)]++] = keys[i];
+	}
+	copy(scratch, scratch + count, keys);
+
+	// Keys in bucket 0 ended at this depth and are all equal, the rest
+	// share one more character so sort them on the next one
+	for(int bucket = 1; bucket < TOTAL_BUCKETS; bucket++)
+	{
+		int size = bucketStart[bucket + 1] - bucketStart[bucket];
+		if(size > 1)
+		{
+			msd_radix_sort(keys + bucketStart[bucket], scratch, size, depth + 1);
+		}
+	}
+}
+
+void string_radix_sorter::multikey_quicksort(radix_key* keys, int count, int depth)
+{
+	while(count > INSERTION_CUTOFF)
+	{
+		// Median of three characters as the pivot
+		int first = bucket_at(keys[0], depth);
+		int middle = bucket_at(keys[count / 2], depth);
+		int last = bucket_at(keys[count - 1], depth);
+		int pivot = max(min(first, middle), min(max(first, middle), last));
+
+		// Split into keys with a smaller, equal and bigger character at this depth
+		int less = 0;
+		int index = 0;
+		int greater = count;
+		while(index < greater)
+		{
+			int bucket = bucket_at(keys[index], depth);
+			if(bucket < pivot)
+			{
+				swap(keys[less++], keys[index++]);
+			}
+			else if(bucket > pivot)
+			{
+				swap(keys[index], keys[--greater]);
+			}
+			else
+			{
+				index++;
+			}
+		}
+
+		multikey_quicksort(keys, less, depth);
+		multikey_quicksort(keys + greater, count - greater, depth);
+
+		// The equal part all ended here if the pivot was the end of string
+		if(pivot == 0)
+		{
+			return;
+		}
+
+		// Otherwise it shares one more character, so keep going on the next one
+		keys += less;
+		count = greater - less;
+		depth++;
+	}
+
+	insertion_sort(keys, count, depth);
+}
+
+void string_radix_sorter::insertion_sort(radix_key* keys, int count, int depth)
+{
+	for(int i = 1; i < count; i++)
+	{
+		radix_key value = keys[i];
+		int insertionIndex = i;
+
+		while(insertionIndex > 0 && less_from(value, keys[insertionIndex - 1], depth))
+		{
+			keys[insertionIndex] = keys[insertionIndex - 1];
+			insertionIndex--;
+		}
+
+		keys[insertionIndex] = value;
+	}
+}
+
+bool string_radix_sorter::less_from(const radix_key& a, const radix_key& b, int depth)
+{
+	int shared = min(a.length, b.length) - depth;
+	int result = shared > 0 ? memcmp(a.data + depth, b.data + depth, shared) : 0;
+	return result < 0 || (result == 0 && a.length < b.length);
+}
@@ -0,0 +1,77 @@
+/*
+ * STRING RADIX SORTER: Time complexity - O(n * average distinguishing prefix)
+ *
+ * MSD radix sort on the characters of the strings, switching to multikey
+ * quicksort once a bucket gets small. Only the characters past the prefix
+ * a bucket already shares are ever looked at again
+ */
+
+#ifndef STRING_RADIX_SORTER_H_
+#define STRING_RADIX_SORTER_H_
+
+#include "sorter.h"
+#include <string>
+#include <vector>
+
+class string_radix_sorter : public sorter<std::string>
+{
+// PUBLIC TYPEDEFS
+public:
+	// Bytes of a key to sort and the index of the element it belongs to
+	struct radix_key
+	{
+		const char* data;
+		int length;
+		int index;
+	};
+
+// PRIVATE DATA
+private:
+	// Buckets smaller than this are sorted with multikey quicksort
+	static const int MULTIKEY_CUTOFF = 64;
+	// Ranges this small or smaller are insertion sorted
+	static const int INSERTION_CUTOFF = 12;
+	// One bucket for keys that ended, one for each byte value
+	static const int TOTAL_BUCKETS = 257;
+
+	// Keys sorted in place of the strings, kept between sorts
+	std::vector<radix_key> keys;
+
+// PUBLIC INTERFACE
+public:
+	string_radix_sorter(int capacity) :
+		sorter<std::string>(capacity) {}
+
+	void sort();
+
+	void sort_report();
+
+	std::string get_name() const { return "String Radix Sort"; }
+
+	// Sort the keys by their bytes compared as unsigned chars, shorter keys
+	// first on a shared prefix (the same order std::string uses)
+	static void radix_sort(radix_key* keys, int count);
+
+// PRIVATE UTILITIES
+private:
+	// Distribute the keys into buckets by the character at the given depth
+	// and sort each bucket at the next depth
+	static void msd_radix_sort(radix_key* keys, radix_key* scratch, int count, int depth);
+
+	// Bentley-Sedgewick three-way quicksort on the character at the given depth
+	static void multikey_quicksort(radix_key* keys, int count, int depth);
+
+	// Insertion sort keys that are known to be equal up to the given depth
+	static void insertion_sort(radix_key* keys, int count, int depth);
+
+	// Bucket of the key at the given depth: 0 past the end, otherwise the byte + 1
+	static int bucket_at(const radix_key& key, int depth)
+	{
+		return depth < key.length ? (unsigned char)key.data[depth] + 1 : 0;
+	}
+
+	// Return true if key a comes before key b, ignoring the first depth bytes
+	static bool less_from(const radix_key& a, const radix_key& b, int depth);
+};
+
+#endif /* STRING_RADIX_SORTER_H_ */
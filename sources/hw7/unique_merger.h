@@ -0,0 +1,134 @@
+/*
+ * unique_merger.h
+ *
+ * Merge sort that removes duplicates as it goes. Every sorted half comes
+ * back as its distinct keys with how often each came up, and merging two
+ * halves adds up the counts of keys they share, so runs shrink as soon
+ * as duplicates meet instead of in a separate pass after the sort
+ */
+
+#ifndef UNIQUE_MERGER_H_
+#define UNIQUE_MERGER_H_
+
+#include "sort_kernels.h"
+#include <utility>
+#include <vector>
+
+// INTERFACE
+
+template<typename Type>
+class unique_merger
+{
+public:
+	// Sort the keys and collapse equal keys into one, leaving the distinct
+	// keys at the front of keys and how often each came up at the front of
+	// counts. Return the number of distinct keys
+	static int sort_count(Type* keys, int* counts, int length);
+
+private:
+	// Ranges this small or smaller are insertion sorted and collapsed
+	static const int INSERTION_CUTOFF = 16;
+
+	// Sort and collapse the range, leaving it at the front of the range,
+	// and return the number of distinct keys in it
+	static int sort_count_recursive(Type* keys, int* counts, Type* scratchKeys, int* scratchCounts, int length);
+
+	// Merge the distinct sorted keys [0, leftLength) and [middle, middle + rightLength)
+	// into the front of the range, adding up the counts of shared keys
+	static int merge(Type* keys, int* counts, Type* scratchKeys, int* scratchCounts,
+			int leftLength, int middle, int rightLength);
+};
+
+// IMPLEMENTATION
+
+template<typename Type>
+int unique_merger<Type>::sort_count(Type* keys, int* counts, int length)
+{
+	std::vector<Type> scratchKeys(length);
+	std::vector<int> scratchCounts(length);
+	return sort_count_recursive(keys, counts, scratchKeys.data(), scratchCounts.data(), length);
+}
+
+template<typename Type>
+int unique_merger<Type>::sort_count_recursive(Type* keys, int* counts, Type* scratchKeys, int* scratchCounts, int length)
+{
+	if(length <= INSERTION_CUTOFF)
+	{
+		sort_kernels<Type>::insertion_sort(keys, 0, length);
+
+		// Collapse runs of equal keys
+		int distinct = 0;
+		for(int i = 0; i < length; i++)
+		{
+			if(distinct > 0 && !(keys[distinct - 1] < keys[i]))
+			{
+				counts[distinct - 1]++;
+			}
+			else
+			{
+				if(distinct != i)
+				{
+					keys[distinct] = std::move(keys[i]);
+				}
+				counts[distinct++] = 1;
+			}
+		}
+		return distinct;
+	}
+
+	int middle = length / 2;
+	int leftLength = sort_count_recursive(keys, counts, scratchKeys, scratchCounts, middle);
+	int rightLength = sort_count_recursive(keys + middle, counts + middle, scratchKeys, scratchCounts, length - middle);
+
+	return merge(keys, counts, scratchKeys, scratchCounts, leftLength, middle, rightLength);
+}
+
+template<typename Type>
+int unique_merger<Type>::merge(Type* keys, int* counts, Type* scratchKeys, int* scratchCounts,
+		int leftLength, int middle, int rightLength)
+{
+	int left = 0;
+	int right = middle;
+	int leftEnd = leftLength;
+	int rightEnd = middle + rightLength;
+	int out = 0;
+
+	while(left < leftEnd && right < rightEnd)
+	{
+		if(keys[left] < keys[right])
+		{
+			scratchKeys[out] = std::move(keys[left]);
+			scratchCounts[out++] = counts[left++];
+		}
+		else if(keys[right] < keys[left])
+		{
+			scratchKeys[out] = std::move(keys[right]);
+			scratchCounts[out++] = counts[right++];
+		}
+		else
+		{
+			// The same key in both halves becomes one key
+			scratchKeys[out] = std::move(keys[left]);
+			scratchCounts[out++] = counts[left++] + counts[right++];
+		}
+	}
+	for(; left < leftEnd; left++)
+	{
+		scratchKeys[out] = std::move(keys[left]);
+		scratchCounts[out++] = counts[left];
+	}
+	for(; right < rightEnd; right++)
+	{
+		scratchKeys[out] = std::move(keys[right]);
+		scratchCounts[out++] = counts[right];
+	}
+
+	for(int i = 0; i < out; i++)
+	{
+		keys[i] = std::move(scratchKeys[i]);
+		counts[i] = scratchCounts[i];
+	}
+	return out;
+}
+
+#endif /* UNIQUE_MERGER_H_ */
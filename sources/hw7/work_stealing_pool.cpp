@@ -0,0 +1,138 @@
+/*
+ * work_stealing_pool.cpp
+ */
+
+#include "work_stealing_pool.h"
+using namespace std;
+
+thread_local work_stealing_pool* work_stealing_pool::currentPool = nullptr;
+thread_local int work_stealing_pool::currentQueue = -1;
+
+work_stealing_pool::work_stealing_pool(int threadCount) :
+	pendingTasks(0), queuedTasks(0), nextQueue(0), stopping(false)
+{
+	if(threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	for(int i = 0; i < threadCount; i++)
+	{
+		queues.emplace_back(new worker_queue());
+	}
+	for(int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back(&work_stealing_pool::worker_loop, this, i);
+	}
+}
+
+void work_stealing_pool::spawn(task newTask)
+{
+	// Workers keep their own tasks local, outside threads deal them out round robin
+	int index = currentPool == this ? currentQueue : nextQueue++ % queues.size();
+
+	pendingTasks++;
+	{
+		lock_guard<mutex> guard(queues[index]->lock);
+		queues[index]->tasks.push_back(move(newTask));
+	}
+	queuedTasks++;
+
+	// Taking the idle lock orders this against a worker checking for work
+	// right before going to sleep, so the wake up cannot be lost
+	{
+		lock_guard<mutex> guard(idleLock);
+	}
+	workAvailable.notify_one();
+}
+
+void work_stealing_pool::wait()
+{
+	unique_lock<mutex> guard(idleLock);
+	allDone.wait(guard, [this]() { return pendingTasks == 0; });
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+	{
+		lock_guard<mutex> guard(idleLock);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+
+	for(thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void work_stealing_pool::worker_loop(int index)
+{
+	currentPool = this;
+	currentQueue = index;
+
+	task current;
+	while(true)
+	{
+		if(try_pop(index, current) || try_steal(index, current))
+		{
+			current();
+			current = nullptr;
+
+			// Wake the waiting thread if that was the last task in flight
+			if(--pendingTasks == 0)
+			{
+				lock_guard<mutex> guard(idleLock);
+				allDone.notify_all();
+			}
+		}
+		else
+		{
+			// Nothing to run or steal, so sleep until something is spawned
+			unique_lock<mutex> guard(idleLock);
+			workAvailable.wait(guard, [this]() { return stopping || queuedTasks > 0; });
+
+			if(stopping)
+			{
+				return;
+			}
+		}
+	}
+}
+
+bool work_stealing_pool::try_pop(int index, task& result)
+{
+	worker_queue& queue = *queues[index];
+	lock_guard<mutex> guard(queue.lock);
+
+	if(queue.tasks.empty())
+	{
+		return false;
+	}
+
+	result = move(queue.tasks.back());
+	queue.tasks.pop_back();
+	queuedTasks--;
+	return true;
+}
+
+bool work_stealing_pool::try_steal(int index, task& result)
+{
+	int total = queues.size();
+
+	// Walk the other deques starting from the next one over
+	for(int offset = 1; offset < total; offset++)
+	{
+		worker_queue& victim = *queues[(index + offset) % total];
+		lock_guard<mutex> guard(victim.lock);
+
+		if(!victim.tasks.empty())
+		{
+			result = move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queuedTasks--;
+			return true;
+		}
+	}
+	return false;
+}
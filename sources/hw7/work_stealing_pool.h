@@ -0,0 +1,101 @@
+/*
+ * work_stealing_pool.h
+ *
+ * A fixed set of worker threads, each with its own deque of tasks. Workers
+ * push and pop tasks at the back of their own deque and steal from the
+ * front of the other deques when they run out of work
+ */
+
+#ifndef WORK_STEALING_POOL_H_
+#define WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class work_stealing_pool
+{
+// PUBLIC TYPEDEFS
+public:
+	typedef std::function<void()> task;
+
+// PRIVATE DATA
+private:
+	// Deque of tasks owned by a single worker
+	struct worker_queue
+	{
+		std::mutex lock;
+		std::deque<task> tasks;
+	};
+
+	std::vector<std::unique_ptr<worker_queue>> queues;
+	std::vector<std::thread> workers;
+	// Tasks spawned but not yet finished running
+	std::atomic<int> pendingTasks;
+	// Tasks sitting in one of the deques
+	std::atomic<int> queuedTasks;
+	// Next deque that tasks spawned from outside the pool go to
+	std::atomic<unsigned int> nextQueue;
+	std::atomic<bool> stopping;
+
+	// Idle workers sleep on this until there is work, the waiting
+	// thread sleeps on it until everything has finished
+	std::mutex idleLock;
+	std::condition_variable workAvailable;
+	std::condition_variable allDone;
+
+	// Pool and deque index of the worker running on this thread, if any
+	static thread_local work_stealing_pool* currentPool;
+	static thread_local int currentQueue;
+
+// PUBLIC INTERFACE
+public:
+	// Start the given number of worker threads
+	work_stealing_pool(int threadCount);
+
+	work_stealing_pool(const work_stealing_pool&) = delete;
+	work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+	// Queue a task. Tasks spawned from a worker go to that worker's own deque
+	void spawn(task);
+
+	// Block until every spawned task, and every task they spawned, has finished
+	void wait();
+
+	// Run the task once per index in [0, count) and wait for all of them
+	template<typename Task>
+	void parallel_for(int count, Task task);
+
+	int thread_count() const { return workers.size(); }
+
+	// Stop and join all workers
+	~work_stealing_pool();
+
+// PRIVATE UTILITIES
+private:
+	// Run tasks for the worker with the given deque index until the pool stops
+	void worker_loop(int index);
+
+	// Take the newest task from the worker's own deque
+	bool try_pop(int index, task&);
+
+	// Take the oldest task from some other worker's deque
+	bool try_steal(int index, task&);
+};
+
+template<typename Task>
+void work_stealing_pool::parallel_for(int count, Task task)
+{
+	for(int index = 0; index < count; index++)
+	{
+		spawn([&task, index]() { task(index); });
+	}
+	wait();
+}
+
+#endif /* WORK_STEALING_POOL_H_ */
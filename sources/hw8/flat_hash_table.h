@@ -0,0 +1,417 @@
+/*
+ * flat_hash_table.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: chuntting0
+ */
+
+#ifndef FLAT_HASH_TABLE_H_
+#define FLAT_HASH_TABLE_H_
+
+#include "hash_table.h"
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Open-addressing hash table with the same interface as hash_table.
+// Key-value pairs live inline in one slot array, and a parallel array
+// holds one control byte per slot: empty, deleted, or the top 7 bits of
+// the key's hash. Slots are probed a group of 16 at a time by comparing
+// all 16 control bytes at once, so most misses touch a single cache line
+// and only slots whose 7 hash bits match ever have their keys compared
+template<typename Type, typename Hasher = default_hasher, typename KeyEqual = std::equal_to<>>
+class flat_hash_table
+{
+	// Allow analyzer full access to the hash table
+	friend class hash_table_analyzer;
+
+// PUBLIC TYPEDEFS
+public:
+	typedef Type value_type;
+	typedef hash_kvp<Type> hash;
+	typedef Hasher hash_generator;
+	typedef KeyEqual key_equal;
+
+	// Number of control bytes compared by each probe
+	static constexpr int GROUP_WIDTH = 16;
+
+// PRIVATE DATA
+private:
+	// Control byte values for slots that do not hold a key.
+	// Full slots hold a value in [0, 127]
+	static constexpr signed char EMPTY = -128;
+	static constexpr signed char DELETED = -2;
+
+	// Tables are never filled past 7/8 of their slots
+	static constexpr int MAX_LOAD_NUMERATOR = 7;
+	static constexpr int MAX_LOAD_DENOMINATOR = 8;
+
+	// One control byte for each slot
+	signed char* control;
+	// Uninitialized storage for the key-value pairs
+	hash* slots;
+	// Total slots, always a power-of-two multiple of the group width
+	int capacity;
+	// Number of slots holding a key
+	int used;
+	// Empty slots that can still be filled before the table must be rehashed
+	int growthLeft;
+	// Function used to generate the hashes for each hash kvp
+	hash_generator hasher;
+	// Function used to check if a stored key matches the key being looked up
+	key_equal equal;
+
+// PUBLIC INTERFACE
+public:
+	// Construct a table that can hold the given number of keys before it grows
+	flat_hash_table(int size, hash_generator hasher = hash_generator(), key_equal equal = key_equal());
+
+	// Setup a new hash generator and re-place every key with it
+	void set_hasher(hash_generator hasher);
+
+	// Insert a kvp into the hash table
+	void insert(const std::string&, const Type&);
+
+	// Find the value associated with the key
+	Type& find(const std::string&) const;
+
+	// Remove a kvp from the hash table
+	void remove(const std::string&);
+
+	// Return the value at the associated key
+	Type& operator[](const std::string&) const;
+
+	// Return a pointer to the value associated with the key,
+	// or null if the key is not in the hash table
+	Type* try_find(std::string_view) const;
+
+	// Return true if a value is associated with the key
+	bool contains(std::string_view key) const { return find_slot(key) >= 0; }
+
+	// Remove a kvp from the hash table and return true,
+	// or return false if the key is not in the hash table
+	bool erase(std::string_view);
+
+	// Number of keys in the table
+	int count() const { return used; }
+
+	// Release resources allocated for the hash table
+	~flat_hash_table();
+
+	// The table owns raw slot storage, so it cannot be copied
+	flat_hash_table(const flat_hash_table&) = delete;
+	flat_hash_table& operator=(const flat_hash_table&) = delete;
+
+// PROTECTED UTILITIES
+protected:
+	// Hash the key and spread the result over 64 bits. The top 7 bits become the
+	// control byte and the bits below them choose the first group. Only the high
+	// bits of the product depend on every bit of the hash, like in hash_table
+	uint64_t hash_of(std::string_view) const;
+	static signed char control_byte(uint64_t hashValue) { return hashValue >> 57; }
+	uint64_t first_group(uint64_t hashValue) const
+	{
+		return ((unsigned __int128)(hashValue << 7) * (uint64_t)(capacity / GROUP_WIDTH)) >> 64;
+	}
+
+	// Index of the slot holding the key, or -1 if the key is not in the table
+	int find_slot(std::string_view) const;
+
+	// Index of the first empty or deleted slot along the key's probe sequence
+	int find_free_slot(uint64_t hashValue) const;
+
+	// Move every key into freshly allocated storage with the given number of slots
+	void rehash(int newCapacity);
+
+	// Allocate control bytes and slots for the given capacity, all marked empty
+	void allocate(int newCapacity);
+
+	// Bit i of the result is set if control byte i of the group equals the value
+	static unsigned int match(const signed char* group, signed char value);
+
+	// Bit i of the result is set if control byte i of the group is empty or deleted
+	static unsigned int match_free(const signed char* group);
+
+	// Index of the lowest set bit in the mask
+	static int lowest_bit(unsigned int mask) { return __builtin_ctz(mask); }
+};
+
+template<typename Type, typename Hasher, typename KeyEqual>
+flat_hash_table<Type, Hasher, KeyEqual>::flat_hash_table(int size, hash_generator hasher, key_equal equal)
+{
+	int newCapacity = GROUP_WIDTH;
+
+	// Grow the capacity until the requested size fits under the maximum load
+	while((long long)newCapacity * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR < size)
+	{
+		newCapacity *= 2;
+	}
+
+	this->hasher = hasher;
+	this->equal = equal;
+	allocate(newCapacity);
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+flat_hash_table<Type, Hasher, KeyEqual>::~flat_hash_table()
+{
+	for(int i = 0; i < capacity; i++)
+	{
+		if(control[i] >= 0)
+		{
+			slots[i].~hash();
+		}
+	}
+	delete [] control;
+	::operator delete(slots);
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void flat_hash_table<Type, Hasher, KeyEqual>::set_hasher(hash_generator hasher)
+{
+	this->hasher = hasher;
+	rehash(capacity);
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void flat_hash_table<Type, Hasher, KeyEqual>::insert(const std::string& key, const Type& value)
+{
+	// Insert only if the key does not already exist in the hash table
+	if(find_slot(key) >= 0)
+	{
+		throw std::invalid_argument("For input key " + key + ": a value is already associated with this key");
+	}
+
+	// If no empty slots are left, either clear out the deleted slots
+	// or double the capacity if the table is genuinely full
+	if(growthLeft == 0)
+	{
+		if(used < capacity * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR / 2)
+		{
+			rehash(capacity);
+		}
+		else
+		{
+			rehash(capacity * 2);
+		}
+	}
+
+	uint64_t hashValue = hash_of(key);
+	int slot = find_free_slot(hashValue);
+
+	// Reusing a deleted slot does not use up an empty one
+	if(control[slot] == EMPTY)
+	{
+		growthLeft--;
+	}
+	control[slot] = control_byte(hashValue);
+	new (&slots[slot]) hash(key, value);
+	used++;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+Type& flat_hash_table<Type, Hasher, KeyEqual>::find(const std::string& key) const
+{
+	return (*this)[key];
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void flat_hash_table<Type, Hasher, KeyEqual>::remove(const std::string& key)
+{
+	if(!erase(key))
+	{
+		throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
+	}
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+Type& flat_hash_table<Type, Hasher, KeyEqual>::operator [](const std::string& key) const
+{
+	Type* value = try_find(key);
+
+	if(value == nullptr)
+	{
+		throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
+	}
+	return *value;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+Type* flat_hash_table<Type, Hasher, KeyEqual>::try_find(std::string_view key) const
+{
+	int slot = find_slot(key);
+	return slot < 0 ? nullptr : &slots[slot].value;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+bool flat_hash_table<Type, Hasher, KeyEqual>::erase(std::string_view key)
+{
+	int slot = find_slot(key);
+
+	if(slot < 0)
+	{
+		return false;
+	}
+
+	slots[slot].~hash();
+	used--;
+
+	// Probes stop at the first group with an empty slot, so if this group
+	// already has one then no probe can pass through it and the slot can
+	// become empty again. Otherwise it must stay as a deleted marker
+	const signed char* group = control + (slot / GROUP_WIDTH) * GROUP_WIDTH;
+	if(match(group, EMPTY))
+	{
+		control[slot] = EMPTY;
+		growthLeft++;
+	}
+	else
+	{
+		control[slot] = DELETED;
+	}
+	return true;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+uint64_t flat_hash_table<Type, Hasher, KeyEqual>::hash_of(std::string_view key) const
+{
+	// Multiply by the golden ratio so that every bit of the hash reaches
+	// the top bits, which is where the control byte and group come from
+	return (uint64_t)hasher(key) * 0x9E3779B97F4A7C15ull;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+int flat_hash_table<Type, Hasher, KeyEqual>::find_slot(std::string_view key) const
+{
+	uint64_t hashValue = hash_of(key);
+	signed char target = control_byte(hashValue);
+	uint64_t groupMask = capacity / GROUP_WIDTH - 1;
+	uint64_t group = first_group(hashValue);
+
+	// Triangular probing visits every group once when the group count is a power of two
+	for(uint64_t step = 1; step <= groupMask + 1; step++)
+	{
+		const signed char* groupControl = control + group * GROUP_WIDTH;
+
+		// Compare keys only in slots whose control byte matches
+		for(unsigned int candidates = match(groupControl, target); candidates; candidates &= candidates - 1)
+		{
+			int slot = group * GROUP_WIDTH + lowest_bit(candidates);
+			if(equal(slots[slot].key, key))
+			{
+				return slot;
+			}
+		}
+
+		// An empty slot means the key would have been placed in this group
+		if(match(groupControl, EMPTY))
+		{
+			return -1;
+		}
+		group = (group + step) & groupMask;
+	}
+	return -1;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+int flat_hash_table<Type, Hasher, KeyEqual>::find_free_slot(uint64_t hashValue) const
+{
+	uint64_t groupMask = capacity / GROUP_WIDTH - 1;
+	uint64_t group = first_group(hashValue);
+
+	// The table is never full, so some group along the sequence has a free slot
+	for(uint64_t step = 1; ; step++)
+	{
+		unsigned int free = match_free(control + group * GROUP_WIDTH);
+		if(free)
+		{
+			return group * GROUP_WIDTH + lowest_bit(free);
+		}
+		group = (group + step) & groupMask;
+	}
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void flat_hash_table<Type, Hasher, KeyEqual>::rehash(int newCapacity)
+{
+	signed char* oldControl = control;
+	hash* oldSlots = slots;
+	int oldCapacity = capacity;
+
+	allocate(newCapacity);
+
+	// Move every full slot into the new storage. Keys are already
+	// known to be unique, so each one goes straight to a free slot
+	for(int i = 0; i < oldCapacity; i++)
+	{
+		if(oldControl[i] >= 0)
+		{
+			uint64_t hashValue = hash_of(oldSlots[i].key);
+			int slot = find_free_slot(hashValue);
+
+			control[slot] = control_byte(hashValue);
+			new (&slots[slot]) hash(std::move(oldSlots[i]));
+			oldSlots[i].~hash();
+			growthLeft--;
+			used++;
+		}
+	}
+
+	delete [] oldControl;
+	::operator delete(oldSlots);
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void flat_hash_table<Type, Hasher, KeyEqual>::allocate(int newCapacity)
+{
+	control = new signed char[newCapacity];
+	slots = static_cast<hash*>(::operator new(sizeof(hash) * newCapacity));
+	capacity = newCapacity;
+	used = 0;
+	growthLeft = newCapacity * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR;
+
+	for(int i = 0; i < newCapacity; i++)
+	{
+		control[i] = EMPTY;
+	}
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+unsigned int flat_hash_table<Type, Hasher, KeyEqual>::match(const signed char* group, signed char value)
+{
+#ifdef __SSE2__
+	__m128i controlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(controlBytes, _mm_set1_epi8(value)));
+#else
+	unsigned int mask = 0;
+	for(int i = 0; i < GROUP_WIDTH; i++)
+	{
+		mask |= (unsigned int)(group[i] == value) << i;
+	}
+	return mask;
+#endif
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+unsigned int flat_hash_table<Type, Hasher, KeyEqual>::match_free(const signed char* group)
+{
+	// Empty and deleted are the only negative control bytes,
+	// so the sign bit of each byte marks a free slot
+#ifdef __SSE2__
+	__m128i controlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+	return _mm_movemask_epi8(controlBytes);
+#else
+	unsigned int mask = 0;
+	for(int i = 0; i < GROUP_WIDTH; i++)
+	{
+		mask |= (unsigned int)(group[i] < 0) << i;
+	}
+	return mask;
+#endif
+}
+
+#endif /* FLAT_HASH_TABLE_H_ */
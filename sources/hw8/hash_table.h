@@ -9,11 +9,14 @@
 #define HASH_TABLE_H_
 
 #include <vector>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <exception>
 #include <functional>
 #include <algorithm>
 #include <iostream>
+#include <utility>
 
 // Simple struct to encapsulate a key-value pair for the hash table
 template<typename Type>
@@ -24,7 +27,15 @@ struct hash_kvp
 	hash_kvp(std::string key, Type value) : key(key), value(value) {}
 };
 
-template<typename Type>
+// Hashers map a key to a full 64-bit hash, and each table reduces
+// the hash to one of its own buckets. Any callable with this
+// signature can be given to a table as its Hasher type
+typedef std::hash<std::string_view> default_hasher;
+
+// Type-erased hasher, for callers that choose the hash function at run time
+typedef std::function<uint64_t(std::string_view)> dynamic_hasher;
+
+template<typename Type, typename Hasher = default_hasher, typename KeyEqual = std::equal_to<>>
 class hash_table
 {
 	// Allow analyzer full access to the hash table
@@ -32,29 +43,47 @@ class hash_table
 
 // PUBLIC TYPEDEFS
 public:
+	typedef Type value_type;
 	typedef hash_kvp<Type> hash;
 	typedef std::vector<hash> hash_chain;
 	typedef typename std::vector<hash>::iterator hash_iterator;
-	typedef std::function<bool(hash)> hash_matcher;
-	typedef std::function<int(const std::string&, int)> hash_generator;
+	typedef Hasher hash_generator;
+	typedef KeyEqual key_equal;
 
 // PRIVATE DATA
 private:
+	// Grow once there is more than one kvp per hash chain on average
+	static constexpr float MAX_LOAD_FACTOR = 1.0f;
+	// Number of old hash chains moved into the new table by each insert or remove
+	static constexpr int MIGRATE_CHAINS_PER_OPERATION = 4;
+
 	// The hash table is an array where each element is itself a chain
 	// of key-value pairs that map to the same hash value
 	hash_chain* table;
 	// Capacity of the array of hash chains
 	int size;
+	// Total kvps stored in the hash table
+	int items;
 	// Function used to generate the hashes for each hash kvp
 	hash_generator hasher;
+	// Function used to check if a stored key matches the key being looked up
+	key_equal equal;
+
+	// While the table is growing, the chains of the previous array that
+	// have not been moved yet. Null when no rehash is in progress
+	hash_chain* oldTable;
+	// Capacity of the previous array of hash chains
+	int oldSize;
+	// Chains before this index in the old table have already been moved
+	int migrateIndex;
 
 // PUBLIC INTERFACE
 public:
 	// Construct the hash table with the given size and given hash-generator
-	hash_table(int size, hash_generator hasher);
+	hash_table(int size, hash_generator hasher = hash_generator(), key_equal equal = key_equal());
 
-	// Setup a new hash generator for the hash table
-	void set_hasher(hash_generator hasher) { this->hasher = hasher; }
+	// Setup a new hash generator for the hash table and re-place every key with it
+	void set_hasher(hash_generator hasher);
 
 	// Insert a kvp into the hash table
 	void insert(const std::string&, const Type&);
@@ -68,123 +97,285 @@ public:
 	// Return the value at the associated key
 	Type& operator[](const std::string&) const;
 
+	// Return a pointer to the value associated with the key,
+	// or null if the key is not in the hash table
+	Type* try_find(std::string_view) const;
+
+	// Return true if a value is associated with the key
+	bool contains(std::string_view key) const { return try_find(key) != nullptr; }
+
+	// Remove a kvp from the hash table and return true,
+	// or return false if the key is not in the hash table
+	bool erase(std::string_view);
+
+	// Make room for the given number of kvps without growing again
+	void reserve(int totalItems);
+
+	// Rebuild the table with at least the given number of hash chains, all at once.
+	// The capacity never drops low enough to exceed the max load factor
+	void rehash(int minSize);
+
+	// Number of kvps in the hash table
+	int count() const { return items; }
+
+	// Number of hash chains new keys are placed in
+	int bucket_count() const { return size; }
+
 	// Release resources allocated for the hash table
-	~hash_table() { delete [] table; }
+	~hash_table() { delete [] table; delete [] oldTable; }
 
 // PROTECTED UTILITIES
 protected:
 	// Get the hash chain stored at the given key
-	hash_chain& get_hash_chain(const std::string&) const;
+	hash_chain& get_hash_chain(std::string_view) const;
+
+	// Reduce the key's hash to an index into an array with the given number of chains.
+	// The hash is spread by the golden ratio first so that weak hashers still
+	// reach every chain, then mapped with a multiply and shift instead of %
+	int chain_index(std::string_view, int tableSize) const;
+
+	// Find the chain holding the key and the key's position in it.
+	// Returns false if the key is not in the hash table
+	bool locate(std::string_view, hash_chain*& chain, hash_iterator& position) const;
+
+	// Begin moving every kvp into a new array with the given capacity.
+	// The old chains are moved a few at a time by later inserts and removes
+	void start_rehash(int newSize);
+
+	// Move up to the given number of old chains into the new table
+	void migrate(int totalChains);
+
+	// Move every remaining old chain into the new table
+	void finish_rehash() { migrate(oldSize); }
+
+	// Smallest prime number greater than or equal to the given number
+	static int next_prime(int);
 
 	// Return a function object that returns true if the given hash matches the given key
-	static hash_matcher match_key(const std::string&);
+	auto match_key(std::string_view key) const
+	{
+		return [this, key](const hash& hashValue){ return this->equal(hashValue.key, key); };
+	}
 };
 
-template<typename Type>
-hash_table<Type>::hash_table(int size, hash_generator hasher)
+template<typename Type, typename Hasher, typename KeyEqual>
+hash_table<Type, Hasher, KeyEqual>::hash_table(int size, hash_generator hasher, key_equal equal)
 {
 	this->table = new hash_chain[size];
 	this->size = size;
+	this->items = 0;
 	this->hasher = hasher;
+	this->equal = equal;
+	this->oldTable = nullptr;
+	this->oldSize = 0;
+	this->migrateIndex = 0;
+}
 
-	// Default construct all vectors
-	for(int i = 0; i < size; i++)
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::set_hasher(hash_generator hasher)
+{
+	this->hasher = hasher;
+
+	// Every key may now belong in a different chain
+	if(this->items > 0)
 	{
-		this->table[i] = hash_chain();
+		rehash(this->size);
 	}
 }
 
 // Add the key-value pair to the vector at the hash calculated for the key
-template<typename Type>
-void hash_table<Type>::insert(const std::string& key, const Type& value)
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::insert(const std::string& key, const Type& value)
 {
-	hash_chain& chain = this->get_hash_chain(key);
+	hash_chain* chain;
+	hash_iterator position;
 
-	// If the chain is empty, add the hash specified
-	if(chain.empty()) {
-		chain.push_back(hash(key, value));
+	// Insert only if the key does not already exist in the hash table
+	if(locate(key, chain, position)) {
+		throw std::invalid_argument("For input key " + key + ": a value is already associated with this key");
 	}
-	// If the chain is not empty, check to make sure the key doesn't already exist
-	else {
-		hash_iterator hashValue = std::find_if(chain.begin(), chain.end(), match_key(key));
 
-		// Insert only if the key does not already exist in the hash table
-		if(hashValue == chain.end()) {
-			chain.push_back(hash(key, value));
-		}
-		else {
-			throw std::invalid_argument("For input key " + key + ": a value is already associated with this key");
-		}
+	// Start growing once the table gets too full. If the last rehash
+	// has not finished yet, it must be finished before the next one begins
+	if(this->items + 1 > this->size * MAX_LOAD_FACTOR) {
+		finish_rehash();
+		start_rehash(next_prime(this->size * 2));
 	}
+
+	// New keys always go into the new table
+	get_hash_chain(key).push_back(hash(key, value));
+	this->items++;
+	migrate(MIGRATE_CHAINS_PER_OPERATION);
 }
 
-template<typename Type>
-Type& hash_table<Type>::find(const std::string& key) const
+template<typename Type, typename Hasher, typename KeyEqual>
+Type& hash_table<Type, Hasher, KeyEqual>::find(const std::string& key) const
 {
 	return (*this)[key];
 }
 
-template<typename Type>
-void hash_table<Type>::remove(const std::string& key)
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::remove(const std::string& key)
 {
-	hash_chain& chain = this->get_hash_chain(key);
+	if(!erase(key)) {
+		throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
+	}
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+Type& hash_table<Type, Hasher, KeyEqual>::operator [](const std::string& key) const
+{
+	Type* value = try_find(key);
 
-	// If the chain is empty, add the hash specified
-	if(chain.empty()) {
+	// If no chain holds the key, throw an exception
+	if(value == nullptr) {
 		throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
 	}
-	// If the chain is not empty, check to make sure the key doesn't already exist
-	else {
-		hash_iterator hashValue = std::find_if(chain.begin(), chain.end(), match_key(key));
+	return *value;
+}
 
-		// Insert only if the key does not already exist in the hash table
-		if(hashValue == chain.end()) {
-			throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
-		}
-		else {
-			chain.erase(hashValue);
-		}
+template<typename Type, typename Hasher, typename KeyEqual>
+Type* hash_table<Type, Hasher, KeyEqual>::try_find(std::string_view key) const
+{
+	hash_chain* chain;
+	hash_iterator position;
+
+	if(locate(key, chain, position)) {
+		return &position->value;
 	}
+	return nullptr;
 }
 
-template<typename Type>
-Type& hash_table<Type>::operator [](const std::string& key) const
+template<typename Type, typename Hasher, typename KeyEqual>
+bool hash_table<Type, Hasher, KeyEqual>::erase(std::string_view key)
 {
-	hash_chain& hashChain = get_hash_chain(key);
+	hash_chain* chain;
+	hash_iterator position;
 
-	// If hash chain is not empty, search it for the given key
-	if(!hashChain.empty()) {
-		hash_iterator iterator = find_if(hashChain.begin(), hashChain.end(), match_key(key));
+	if(!locate(key, chain, position)) {
+		return false;
+	}
 
-		// If an iterator was found, return its value
-		if(iterator != hashChain.end())
-		{
-			return iterator->value;
+	chain->erase(position);
+	this->items--;
+	migrate(MIGRATE_CHAINS_PER_OPERATION);
+	return true;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::reserve(int totalItems)
+{
+	// Only rebuild if the items would not already fit
+	if(totalItems > this->size * MAX_LOAD_FACTOR) {
+		rehash((int)(totalItems / MAX_LOAD_FACTOR));
+	}
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::rehash(int minSize)
+{
+	int newSize = std::max(minSize, (int)(this->items / MAX_LOAD_FACTOR));
+
+	finish_rehash();
+	start_rehash(next_prime(std::max(newSize, 1)));
+	finish_rehash();
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+typename hash_table<Type, Hasher, KeyEqual>::hash_chain&
+hash_table<Type, Hasher, KeyEqual>::get_hash_chain(std::string_view key) const
+{
+	return this->table[chain_index(key, this->size)];
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+int hash_table<Type, Hasher, KeyEqual>::chain_index(std::string_view key, int tableSize) const
+{
+	uint64_t hashValue = (uint64_t)this->hasher(key) * 0x9E3779B97F4A7C15ull;
+	return ((unsigned __int128)hashValue * (uint64_t)tableSize) >> 64;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+bool hash_table<Type, Hasher, KeyEqual>::locate(std::string_view key, hash_chain*& chain, hash_iterator& position) const
+{
+	// Search the new table first, since all new keys go there
+	chain = &get_hash_chain(key);
+	position = std::find_if(chain->begin(), chain->end(), match_key(key));
+	if(position != chain->end()) {
+		return true;
+	}
+
+	// If a rehash is in progress, the key may still be in an old chain that has not been moved
+	if(this->oldTable != nullptr) {
+		int oldIndex = chain_index(key, this->oldSize);
+		if(oldIndex >= this->migrateIndex) {
+			chain = &this->oldTable[oldIndex];
+			position = std::find_if(chain->begin(), chain->end(), match_key(key));
+			return position != chain->end();
 		}
-		// If no iterator was found, throw an exception
-		else
+	}
+	return false;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::start_rehash(int newSize)
+{
+	this->oldTable = this->table;
+	this->oldSize = this->size;
+	this->migrateIndex = 0;
+	this->table = new hash_chain[newSize];
+	this->size = newSize;
+}
+
+template<typename Type, typename Hasher, typename KeyEqual>
+void hash_table<Type, Hasher, KeyEqual>::migrate(int totalChains)
+{
+	if(this->oldTable == nullptr) {
+		return;
+	}
+
+	int end = std::min(this->oldSize, this->migrateIndex + totalChains);
+	for(; this->migrateIndex < end; this->migrateIndex++)
+	{
+		hash_chain& oldChain = this->oldTable[this->migrateIndex];
+		for(hash& hashValue : oldChain)
 		{
-			throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
+			get_hash_chain(hashValue.key).push_back(std::move(hashValue));
 		}
+		// Release the old chain's memory right away
+		hash_chain().swap(oldChain);
 	}
-	// If the hash chain found has no hashes, throw an exception
-	else {
-		throw std::invalid_argument("For input key " + key + ": no such key exists in the hash table");
+
+	// Once every chain has been moved the old table can be released
+	if(this->migrateIndex == this->oldSize) {
+		delete [] this->oldTable;
+		this->oldTable = nullptr;
+		this->oldSize = 0;
+		this->migrateIndex = 0;
 	}
 }
 
-template<typename Type>
-typename hash_table<Type>::hash_chain&
-hash_table<Type>::get_hash_chain(const std::string& key) const
+template<typename Type, typename Hasher, typename KeyEqual>
+int hash_table<Type, Hasher, KeyEqual>::next_prime(int number)
 {
-	return this->table[this->hasher(key, this->size)];
-}
+	if(number <= 2) {
+		return 2;
+	}
 
-template<typename Type>
-typename hash_table<Type>::hash_matcher
-hash_table<Type>::match_key(const std::string& key)
-{
-	return [&key](const hash& hashValue){ return hashValue.key == key; };
+	// Only odd numbers past two can be prime
+	int candidate = number | 1;
+	while(true)
+	{
+		bool prime = true;
+		for(int divisor = 3; divisor <= candidate / divisor && prime; divisor += 2)
+		{
+			prime = candidate % divisor != 0;
+		}
+		if(prime) {
+			return candidate;
+		}
+		candidate += 2;
+	}
 }
 
 #endif /* HASH_TABLE_H_ */
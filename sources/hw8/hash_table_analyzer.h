@@ -9,6 +9,7 @@
 #define HASH_TABLE_ANALYZER_H_
 
 #include "hash_table.h"
+#include "flat_hash_table.h"
 #include <chrono>
 #include <iostream>
 #include <fstream>
@@ -22,18 +23,19 @@ public:
 	// Encapsulates info about the hash table's hash chains
 	struct hash_table_chain_stats
 	{
+		int chains;
 		int max;
 		int min;
-		int avg;
-		int standardDev;
+		float avg;
+		float standardDev;
 	};
 
 	// Store the stats for each of the algorithms in the hash table
 	struct hash_table_algorithm_stats
 	{
-		std::chrono::milliseconds insertAllTime;
-		std::chrono::milliseconds findAllTime;
-		std::chrono::milliseconds removeAllTime;
+		std::chrono::microseconds insertAllTime;
+		std::chrono::microseconds findAllTime;
+		std::chrono::microseconds removeAllTime;
 		int totalItems;
 	};
 
@@ -42,61 +44,96 @@ public:
 	{
 		hash_table_algorithm_stats algorithmStats;
 		hash_table_chain_stats chainStats;
+		// Gigabytes of keys the table's hasher hashes per second
+		double hasherThroughput;
+	};
+
+	// Encapsulates info about how far keys sit from their first probed group
+	// in an open-addressing table. A probe length of 1 means the key was
+	// found in the first group of control bytes compared
+	struct hash_table_probe_stats
+	{
+		int maxProbeLength;
+		float avgProbeLength;
+		float loadFactor;
+	};
+
+	// Encapsulate all stats about an open-addressing hash table
+	struct flat_hash_table_stats
+	{
+		hash_table_algorithm_stats algorithmStats;
+		hash_table_probe_stats probeStats;
 	};
 
 // PUBLIC INTERFACE
 public:
-	template<typename Type>
-	static hash_table_stats get_all_stats(hash_table<Type>&, const char*, int numElements);
+	template<typename Type, typename... Policy>
+	static hash_table_stats get_all_stats(hash_table<Type, Policy...>&, const char*, int numElements);
+
+	template<typename Type, typename... Policy>
+	static flat_hash_table_stats get_all_stats(flat_hash_table<Type, Policy...>&, const char*, int numElements);
 
-	// Test all of the algorithms on the given hash table and return a struct with all the report data
-	template<typename Type>
-	static hash_table_algorithm_stats get_algorithm_stats(hash_table<Type>&,
+	// Test all of the algorithms on the given hash table and return a struct with all the report data.
+	// The algorithms work on any table with the hash_table interface
+	template<typename Table>
+	static hash_table_algorithm_stats get_algorithm_stats(Table&,
 			const char* filename, int numElements);
 
 	// Insert the number of string keys from the file name and return the time it takes
-	template<typename Type>
-	static std::chrono::milliseconds insert_all(hash_table<Type>&,
+	template<typename Table>
+	static std::chrono::microseconds insert_all(Table&,
 			const std::vector<std::string>& keys);
 
 	// Find every string in the file name and return the time it takes
-	template<typename Type>
-	static std::chrono::milliseconds find_all(const hash_table<Type>&,
+	template<typename Table>
+	static std::chrono::microseconds find_all(const Table&,
 			const std::vector<std::string>& keys);
 
 	// Remove every string in the file name and return the time it takes
-	template<typename Type>
-	static std::chrono::milliseconds remove_all(hash_table<Type>&,
+	template<typename Table>
+	static std::chrono::microseconds remove_all(Table&,
 			const std::vector<std::string>& keys);
 
 	// Return a struct containing all stats about the hash chains in the given hash table
-	template<typename Type>
-	static hash_table_chain_stats get_hash_chain_stats(const hash_table<Type>&);
+	template<typename Type, typename... Policy>
+	static hash_table_chain_stats get_hash_chain_stats(const hash_table<Type, Policy...>&);
 
 	// Analyze hash chain lengths
-	template<typename Type>
-	static int max_hash_chain_length(const hash_table<Type>&);
+	template<typename Type, typename... Policy>
+	static int max_hash_chain_length(const hash_table<Type, Policy...>&);
 
-	template<typename Type>
-	static int min_hash_chain_length(const hash_table<Type>&);
+	template<typename Type, typename... Policy>
+	static int min_hash_chain_length(const hash_table<Type, Policy...>&);
 
-	template<typename Type>
-	static int avg_hash_chain_length(const hash_table<Type>&);
+	template<typename Type, typename... Policy>
+	static float avg_hash_chain_length(const hash_table<Type, Policy...>&);
 
-	template<typename Type>
-	static int standard_dev_hash_chain_length(const hash_table<Type>&);
+	template<typename Type, typename... Policy>
+	static float standard_dev_hash_chain_length(const hash_table<Type, Policy...>&);
+
+	// Hash every key over and over for at least THROUGHPUT_MILLISECONDS
+	// and return the gigabytes of keys hashed per second
+	template<typename Hasher>
+	static double hasher_throughput(const Hasher&, const std::vector<std::string>& keys);
+
+	// Return a struct containing all stats about the probe lengths in the given open-addressing table
+	template<typename Type, typename... Policy>
+	static hash_table_probe_stats get_probe_stats(const flat_hash_table<Type, Policy...>&);
 
 // PROTECTED UTILITIES
 protected:
-	template<typename Type>
-	static int total_hash_chain_lengths(const hash_table<Type>&);
+	// Minimum time spent measuring each hasher's throughput
+	static constexpr int THROUGHPUT_MILLISECONDS = 20;
+
+	template<typename Type, typename... Policy>
+	static int total_hash_chain_lengths(const hash_table<Type, Policy...>&);
 
 	static std::vector<std::string> get_strings_from_file(const char* filename, int numElements);
 };
 
-template<typename Type>
+template<typename Type, typename... Policy>
 hash_table_analyzer::hash_table_stats
-hash_table_analyzer::get_all_stats(hash_table<Type>& table,
+hash_table_analyzer::get_all_stats(hash_table<Type, Policy...>& table,
 		const char* filename, int numElements)
 {
 	hash_table_stats stats;
@@ -106,8 +143,11 @@ hash_table_analyzer::get_all_stats(hash_table<Type>& table,
 	stats.algorithmStats.totalItems = numElements;
 	stats.algorithmStats.insertAllTime = insert_all(table, keys);
 
-	// Get the hash chain stats while all are inserted
+	// Get the hash chain stats while all are inserted, once
+	// every kvp has been moved into the table's current chains
+	table.finish_rehash();
 	stats.chainStats = get_hash_chain_stats(table);
+	stats.hasherThroughput = hasher_throughput(table.hasher, keys);
 
 	// Finally, time finding and removing all elements
 	stats.algorithmStats.findAllTime = find_all(table, keys);
@@ -116,9 +156,31 @@ hash_table_analyzer::get_all_stats(hash_table<Type>& table,
 	return stats;
 }
 
-template<typename Type>
+template<typename Type, typename... Policy>
+hash_table_analyzer::flat_hash_table_stats
+hash_table_analyzer::get_all_stats(flat_hash_table<Type, Policy...>& table,
+		const char* filename, int numElements)
+{
+	flat_hash_table_stats stats;
+	std::vector<std::string> keys = get_strings_from_file(filename, numElements);
+
+	// Start by inserting all and timing it
+	stats.algorithmStats.totalItems = numElements;
+	stats.algorithmStats.insertAllTime = insert_all(table, keys);
+
+	// Get the probe stats while all are inserted
+	stats.probeStats = get_probe_stats(table);
+
+	// Finally, time finding and removing all elements
+	stats.algorithmStats.findAllTime = find_all(table, keys);
+	stats.algorithmStats.removeAllTime = remove_all(table, keys);
+
+	return stats;
+}
+
+template<typename Table>
 hash_table_analyzer::hash_table_algorithm_stats
-hash_table_analyzer::get_algorithm_stats(hash_table<Type>& table,
+hash_table_analyzer::get_algorithm_stats(Table& table,
 		const char* filename, int numElements)
 {
 	std::vector<std::string> keys = get_strings_from_file(filename, numElements);
@@ -132,78 +194,73 @@ hash_table_analyzer::get_algorithm_stats(hash_table<Type>& table,
 	};
 }
 
-template<typename Type>
-std::chrono::milliseconds
-hash_table_analyzer::insert_all(hash_table<Type>& table,
+template<typename Table>
+std::chrono::microseconds
+hash_table_analyzer::insert_all(Table& table,
 		const std::vector<std::string>& keys)
 {
 	auto insert = [&table](const std::string& key)
 	{
-		table.insert(key, Type());
+		table.insert(key, typename Table::value_type());
 	};
 
 	// Get time before and after inserting all strings
-	auto begin = std::chrono::system_clock::now();
+	auto begin = std::chrono::steady_clock::now();
 	std::for_each(keys.begin(), keys.end(), insert);
-	auto end = std::chrono::system_clock::now();
+	auto end = std::chrono::steady_clock::now();
 
 	// Return time difference
-	return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
+	return std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
 }
 
-template<typename Type>
-std::chrono::milliseconds
-hash_table_analyzer::find_all(const hash_table<Type>& table,
+template<typename Table>
+std::chrono::microseconds
+hash_table_analyzer::find_all(const Table& table,
 		const std::vector<std::string>& keys)
 {
 	auto find = [&table](const std::string& key)
 	{
-		try {
-			table.find(key);
-		}
-		catch(std::invalid_argument& invError) {
+		if(!table.contains(key)) {
 			std::cerr << "Did not find key " << key << std::endl;
 		}
 	};
 
 	// Get time before and after inserting all strings
-	auto begin = std::chrono::system_clock::now();
+	auto begin = std::chrono::steady_clock::now();
 	std::for_each(keys.begin(), keys.end(), find);
-	auto end = std::chrono::system_clock::now();
+	auto end = std::chrono::steady_clock::now();
 
 	// Return time difference
-	return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
+	return std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
 }
 
-template<typename Type>
-std::chrono::milliseconds
-hash_table_analyzer::remove_all(hash_table<Type>& table,
+template<typename Table>
+std::chrono::microseconds
+hash_table_analyzer::remove_all(Table& table,
 		const std::vector<std::string>& keys)
 {
 	auto remove = [&table](const std::string& key)
 	{
-		try {
-			table.remove(key);
-		}
-		catch(std::invalid_argument& invError) {
+		if(!table.erase(key)) {
 			std::cerr << "Did not find key " << key << std::endl;
 		}
 	};
 
 	// Get time before and after inserting all strings
-	auto begin = std::chrono::system_clock::now();
+	auto begin = std::chrono::steady_clock::now();
 	std::for_each(keys.begin(), keys.end(), remove);
-	auto end = std::chrono::system_clock::now();
+	auto end = std::chrono::steady_clock::now();
 
 	// Return time difference
-	return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
+	return std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
 }
 
-template<typename Type>
+template<typename Type, typename... Policy>
 hash_table_analyzer::hash_table_chain_stats
-hash_table_analyzer::get_hash_chain_stats(const hash_table<Type>& table)
+hash_table_analyzer::get_hash_chain_stats(const hash_table<Type, Policy...>& table)
 {
 	return hash_table_chain_stats {
+		table.size,
 		max_hash_chain_length(table),
 		min_hash_chain_length(table),
 		avg_hash_chain_length(table),
@@ -211,8 +268,8 @@ hash_table_analyzer::get_hash_chain_stats(const hash_table<Type>& table)
 	};
 }
 
-template<typename Type>
-int hash_table_analyzer::max_hash_chain_length(const hash_table<Type>& table)
+template<typename Type, typename... Policy>
+int hash_table_analyzer::max_hash_chain_length(const hash_table<Type, Policy...>& table)
 {
 	unsigned int maxSize = 0;
 	for(int i = 0; i < table.size; i++)
@@ -225,8 +282,8 @@ int hash_table_analyzer::max_hash_chain_length(const hash_table<Type>& table)
 	return maxSize;
 }
 
-template<typename Type>
-int hash_table_analyzer::min_hash_chain_length(const hash_table<Type>& table)
+template<typename Type, typename... Policy>
+int hash_table_analyzer::min_hash_chain_length(const hash_table<Type, Policy...>& table)
 {
 	unsigned int minSize = table.table[0].size();
 	for(int i = 0; i < table.size; i++)
@@ -239,36 +296,108 @@ int hash_table_analyzer::min_hash_chain_length(const hash_table<Type>& table)
 	return minSize;
 }
 
-template<typename Type>
-int hash_table_analyzer::avg_hash_chain_length(const hash_table<Type>& table)
+template<typename Type, typename... Policy>
+float hash_table_analyzer::avg_hash_chain_length(const hash_table<Type, Policy...>& table)
 {
 	return total_hash_chain_lengths(table) / (float)table.size;
 }
 
-template<typename Type>
-int hash_table_analyzer::standard_dev_hash_chain_length(const hash_table<Type>& table)
+template<typename Type, typename... Policy>
+float hash_table_analyzer::standard_dev_hash_chain_length(const hash_table<Type, Policy...>& table)
 {
-	int average = avg_hash_chain_length(table);
-	int sumDeviations = 0;	// Sum of the differences of each chain length from the mean
+	float average = avg_hash_chain_length(table);
+	float sumDeviations = 0;	// Sum of the squared differences of each chain length from the mean
 	for(int i = 0; i < table.size; i++)
 	{
-		sumDeviations += (table.table[i].size() - average) * (table.table[i].size() - average);
+		float deviation = table.table[i].size() - average;
+		sumDeviations += deviation * deviation;
 	}
 	return std::sqrt(sumDeviations / (float)table.size);
 }
 
-template<typename Type>
-int hash_table_analyzer::total_hash_chain_lengths(const hash_table<Type>& table)
+template<typename Type, typename... Policy>
+int hash_table_analyzer::total_hash_chain_lengths(const hash_table<Type, Policy...>& table)
 {
 	unsigned int sizes = 0;
 	for(int i = 0; i < table.size; i++)
 	{
-		if(table.table[i].size() > sizes)
+		sizes += table.table[i].size();
+	}
+	return sizes;
+}
+
+template<typename Hasher>
+double hash_table_analyzer::hasher_throughput(const Hasher& hasher,
+		const std::vector<std::string>& keys)
+{
+	double totalBytes = 0;
+	for(const std::string& key : keys)
+	{
+		totalBytes += key.size();
+	}
+	if(totalBytes == 0)
+	{
+		return 0;
+	}
+
+	// Sum the hashes so the calls cannot be optimized away
+	uint64_t hashSum = 0;
+	int rounds = 0;
+	std::chrono::steady_clock::duration elapsed;
+	auto begin = std::chrono::steady_clock::now();
+	do
+	{
+		for(const std::string& key : keys)
 		{
-			sizes += table.table[i].size();
+			hashSum += hasher(key);
 		}
+		rounds++;
+		elapsed = std::chrono::steady_clock::now() - begin;
 	}
-	return sizes;
+	while(elapsed < std::chrono::milliseconds(THROUGHPUT_MILLISECONDS));
+
+	volatile uint64_t keepSum = hashSum;
+	(void)keepSum;
+
+	double seconds = std::chrono::duration<double>(elapsed).count();
+	return totalBytes * rounds / seconds / 1e9;
+}
+
+template<typename Type, typename... Policy>
+hash_table_analyzer::hash_table_probe_stats
+hash_table_analyzer::get_probe_stats(const flat_hash_table<Type, Policy...>& table)
+{
+	const int groupWidth = flat_hash_table<Type, Policy...>::GROUP_WIDTH;
+	uint64_t groupMask = table.capacity / groupWidth - 1;
+	int maxProbe = 0;
+	long long totalProbes = 0;
+
+	for(int i = 0; i < table.capacity; i++)
+	{
+		// Skip empty and deleted slots
+		if(table.control[i] < 0)
+		{
+			continue;
+		}
+
+		// Walk the key's probe sequence until it reaches the group holding the key
+		uint64_t group = table.first_group(table.hash_of(table.slots[i].key));
+		int probes = 1;
+		while(group != (uint64_t)(i / groupWidth))
+		{
+			group = (group + probes) & groupMask;
+			probes++;
+		}
+
+		maxProbe = std::max(maxProbe, probes);
+		totalProbes += probes;
+	}
+
+	return hash_table_probe_stats {
+		maxProbe,
+		table.used > 0 ? totalProbes / (float)table.used : 0,
+		table.used / (float)table.capacity
+	};
 }
 
 
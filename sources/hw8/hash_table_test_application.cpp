@@ -6,6 +6,7 @@
  */
 
 #include "hash_table_test_application.h"
+#include <iomanip>
 using namespace std;
 
 void hash_table_test_application::report_hash_table_algorithm_stats(ostream& out,
@@ -15,9 +16,6 @@ void hash_table_test_application::report_hash_table_algorithm_stats(ostream& out
 	hash_table_analyzer::hash_table_algorithm_stats stats;
 	int totalElements;	// Total elements to test the hash table
 
-	// Set the hasher to use the general hasher
-	table.set_hasher(general_hasher());
-
 	for(int currentFile = 0; currentFile < totalInputFiles; currentFile++)
 	{
 		// Output the name of the file being tested
@@ -33,9 +31,9 @@ void hash_table_test_application::report_hash_table_algorithm_stats(ostream& out
 					inputFiles[currentFile].c_str(), totalElements);
 
 			out << "--- Testing with " << totalElements << " strings ---" << endl;
-			out << "Inserted all in: " << stats.insertAllTime.count() << " milliseconds" << endl;
-			out << "Found all in:    " << stats.findAllTime.count() << " milliseconds" << endl;
-			out << "Removed all in:  " << stats.removeAllTime.count() << " milliseconds" << endl;
+			out << "Inserted all in: " << stats.insertAllTime.count() << " microseconds" << endl;
+			out << "Found all in:    " << stats.findAllTime.count() << " microseconds" << endl;
+			out << "Removed all in:  " << stats.removeAllTime.count() << " microseconds" << endl;
 			out << endl;
 		}
 	}
@@ -44,19 +42,85 @@ void hash_table_test_application::report_hash_table_algorithm_stats(ostream& out
 void hash_table_test_application::report_different_hasher_stats(ostream& out,
 		const char* filename, int numElements)
 {
-	hash_table_analyzer::hash_table_stats stats;
+	report_hasher_stats<bit_shift_hasher>(out, "Bit shift hasher", filename, numElements);
+	report_hasher_stats<sum_hasher>(out, "Summation hasher", filename, numElements);
+	report_hasher_stats<product_hasher>(out, "Product hasher", filename, numElements);
+	report_hasher_stats<fast_hasher>(out, "Fast hasher", filename, numElements);
+	report_hasher_stats<seeded_hasher>(out, "Seeded hasher", filename, numElements);
+}
 
-	table.set_hasher(bit_shift_hasher());
-	stats = hash_table_analyzer::get_all_stats(table, filename, numElements);
-	output_hash_table_stats(out, "Bit shift hasher", stats);
+template<typename Hasher>
+void hash_table_test_application::report_hasher_stats(ostream& out, const string& hasherName,
+		const char* filename, int numElements)
+{
+	hash_table<int, Hasher> hasherTable(tableSize);
+	output_hash_table_stats(out, hasherName,
+			hash_table_analyzer::get_all_stats(hasherTable, filename, numElements));
+}
 
-	table.set_hasher(sum_hasher());
-	stats = hash_table_analyzer::get_all_stats(table, filename, numElements);
-	output_hash_table_stats(out, "Summation hasher", stats);
+void hash_table_test_application::report_hasher_throughput(ostream& out,
+		const int* keyLengths, int totalKeyLengths)
+{
+	// Hash about this many bytes of keys per measurement
+	const int bytesPerLength = 1 << 16;
+	// Restore the caller's number formatting once the table is printed
+	const ios_base::fmtflags flags = out.flags();
+	const streamsize precision = out.precision();
+
+	out << "|-------------------|" << endl;
+	out << "| Hasher throughput | GB/s by key length in bytes" << endl;
+	out << "|-------------------|" << endl << endl;
+
+	out << setw(20) << left << "Hasher";
+	for(int i = 0; i < totalKeyLengths; i++)
+	{
+		out << setw(10) << right << keyLengths[i];
+	}
+	out << endl;
+
+	// Output one row, calling the hasher through its own type so
+	// the call can be inlined into the measuring loop
+	auto output_row = [&](const string& name, const auto& hasher)
+	{
+		out << setw(20) << left << name;
+		for(int i = 0; i < totalKeyLengths; i++)
+		{
+			// Fill keys of this length with varying printable characters
+			vector<string> keys(max(1, bytesPerLength / keyLengths[i]), string(keyLengths[i], ' '));
+			for(unsigned int key = 0; key < keys.size(); key++)
+			{
+				for(int c = 0; c < keyLengths[i]; c++)
+				{
+					keys[key][c] = 'a' + (key * 7 + c * 13) % 26;
+				}
+			}
+
+			out << setw(10) << right << fixed << setprecision(3)
+				<< hash_table_analyzer::hasher_throughput(hasher, keys);
+		}
+		out << endl;
+	};
 
-	table.set_hasher(product_hasher());
-	stats = hash_table_analyzer::get_all_stats(table, filename, numElements);
-	output_hash_table_stats(out, "Product hasher", stats);
+	output_row("General hasher", general_hasher());
+	output_row("Bit shift hasher", bit_shift_hasher());
+	output_row("Summation hasher", sum_hasher());
+	output_row("Product hasher", product_hasher());
+	output_row("Fast hasher", fast_hasher());
+	output_row("Seeded hasher", seeded_hasher());
+	out << endl;
+
+	out.flags(flags);
+	out.precision(precision);
+}
+
+void hash_table_test_application::report_flat_table_comparison(ostream& out,
+		const char* filename, int numElements)
+{
+	output_hash_table_stats(out, "Chained table, general hasher",
+			hash_table_analyzer::get_all_stats(table, filename, numElements));
+
+	output_flat_table_stats(out, "Open-addressing table, general hasher",
+			hash_table_analyzer::get_all_stats(flatTable, filename, numElements));
 }
 
 void hash_table_test_application::output_hash_table_stats(ostream& out, const string& hasherName,
@@ -68,94 +132,93 @@ void hash_table_test_application::output_hash_table_stats(ostream& out, const st
 
 	// Output stats on hash chain stats
 	out << "Hash chain stats" << endl;
+	out << "\tNumber of chains:   " << stats.chainStats.chains << endl;
 	out << "\tMaximum length:     " << stats.chainStats.max << endl;
 	out << "\tMinimum length:     " << stats.chainStats.min << endl;
 	out << "\tAverage length:     " << stats.chainStats.avg << endl;
-	out << "\tStandard deviation: " << stats.chainStats.standardDev << endl << endl;
+	out << "\tStandard deviation: " << stats.chainStats.standardDev << endl;
+	out << "\tHasher throughput:  " << stats.hasherThroughput << " GB/s" << endl << endl;
+
+	// Output stats on algorithm stats
+	out << "Hash table algorithm performance" << endl;
+	out << "\tInsert all: " << stats.algorithmStats.insertAllTime.count() << " microseconds" << endl;
+	out << "\tFind all:   " << stats.algorithmStats.findAllTime.count() << " microseconds" << endl;
+	out << "\tRemove all: " << stats.algorithmStats.removeAllTime.count() << " microseconds" << endl << endl;
+}
+
+void hash_table_test_application::output_flat_table_stats(ostream& out, const string& tableName,
+		hash_table_analyzer::flat_hash_table_stats stats)
+{
+	out << "|-----------------|" << endl;
+	out << "| Stats for table | " << tableName << endl;
+	out << "|-----------------|" << endl << endl;
+
+	// Output stats on how many groups were probed to reach each key
+	out << "Probe stats" << endl;
+	out << "\tMaximum groups probed: " << stats.probeStats.maxProbeLength << endl;
+	out << "\tAverage groups probed: " << stats.probeStats.avgProbeLength << endl;
+	out << "\tLoad factor:           " << stats.probeStats.loadFactor << endl << endl;
 
 	// Output stats on algorithm stats
 	out << "Hash table algorithm performance" << endl;
-	out << "\tInsert all: " << stats.algorithmStats.insertAllTime.count() << " milliseconds" << endl;
-	out << "\tFind all:   " << stats.algorithmStats.findAllTime.count() << " milliseconds" << endl;
-	out << "\tRemove all: " << stats.algorithmStats.removeAllTime.count() << " milliseconds" << endl << endl;
+	out << "\tInsert all: " << stats.algorithmStats.insertAllTime.count() << " microseconds" << endl;
+	out << "\tFind all:   " << stats.algorithmStats.findAllTime.count() << " microseconds" << endl;
+	out << "\tRemove all: " << stats.algorithmStats.removeAllTime.count() << " microseconds" << endl << endl;
 }
 
-hash_table_test_application::hasher
-hash_table_test_application::general_hasher()
+uint64_t hash_table_test_application::general_hasher::operator()(string_view key) const
 {
-	auto hashFunction = [](const string& key, int maxHash)
+	// Let the polynomial wrap around 64 bits instead of reducing every character
+	uint64_t hash = 0;
+	for(unsigned int i = 0; i < key.size(); i++)
 	{
-		unsigned int hash = 0;
-		for(unsigned int i = 0; i < key.size(); i++)
-		{
-			hash = (127 * hash + key[i]) % 16908799;
-		}
-		return hash % maxHash;
-	};
-	return hashFunction;
+		hash = 127 * hash + (unsigned char)key[i];
+	}
+	return hash;
 }
 
-hash_table_test_application::hasher
-hash_table_test_application::bit_shift_hasher()
+uint64_t hash_table_test_application::bit_shift_hasher::operator()(string_view key) const
 {
-	auto hashFunction = [](const string& key, int maxHash)
+	const unsigned int shift = 6;
+	const unsigned int zero = 0;
+	unsigned int mask = ~zero >> (32 - shift);
+	unsigned int result = 0;
+	for(unsigned int i = 0; i < key.size(); i++)
 	{
-		const unsigned int shift = 6;
-		const unsigned int zero = 0;
-		unsigned int mask = ~zero >> (32 - shift);
-		unsigned int result = 0;
-		for(unsigned int i = 0; i < key.size(); i++)
-		{
-			result = (result << shift) | (key[i] & mask);
-		}
-		return result % maxHash;
-	};
-	return hashFunction;
+		result = (result << shift) | (key[i] & mask);
+	}
+	return (uint64_t)result;
 }
 
-hash_table_test_application::hasher
-hash_table_test_application::sum_hasher()
+uint64_t hash_table_test_application::sum_hasher::operator()(string_view key) const
 {
-	auto hashFunction = [](const string& key, int maxHash)
+	uint64_t result = 0;
+	for(unsigned int i = 0; i < key.size(); i++)
 	{
-		int result = 0;
-		for(unsigned int i = 0; i < key.size(); i++)
-		{
-			result += key[i];
-		}
-		return abs(result) % maxHash;
-	};
-	return hashFunction;
+		result += (unsigned char)key[i];
+	}
+	return result;
 }
 
-hash_table_test_application::hasher
-hash_table_test_application::product_hasher()
+uint64_t hash_table_test_application::product_hasher::operator()(string_view key) const
 {
-	auto hashFunction = [](const string& key, int maxHash)
+	// Unsigned so the product wraps instead of overflowing
+	uint64_t result = 1;
+	for(unsigned int i = 0; i < key.size(); i++)
 	{
-		int result = 1;
-		for(unsigned int i = 0; i < key.size(); i++)
-		{
-			result *= key[i];
-		}
-		return abs(result) % maxHash;
-	};
-	return hashFunction;
+		result *= (unsigned char)key[i];
+	}
+	return result;
 }
 
-hash_table_test_application::hasher
-hash_table_test_application::my_hasher()
+uint64_t hash_table_test_application::my_hasher::operator()(string_view key) const
 {
-	auto hash_function = [](const string& key, int maxHash)
+	if(key.size() > 0)
 	{
-		if(key.size() > 0)
-		{
-			return (int)((key.size() + key.at(0)) % maxHash);
-		}
-		else
-		{
-			return (int)(maxHash / 2);
-		}
-	};
-	return hash_function;
+		return (uint64_t)(key.size() + key.at(0));
+	}
+	else
+	{
+		return (uint64_t)0;
+	}
 }
@@ -9,22 +9,34 @@
 #define HASH_TABLE_TEST_APPLICATION_H_
 
 #include "hash_table_analyzer.h"
+#include "string_hashers.h"
 #include <chrono>
 #include <iostream>
 
 class hash_table_test_application
 {
-// PUBLIC TYPEDEFS
-public:
-	typedef typename hash_table<int>::hash_generator hasher;
+// PROTECTED TYPEDEFS
+protected:
+	// Different hash functions for the hash table. Each is its own type, so
+	// the tables below call it directly instead of through a std::function
+	struct general_hasher { uint64_t operator()(std::string_view key) const; };
+	struct bit_shift_hasher { uint64_t operator()(std::string_view key) const; };
+	struct sum_hasher { uint64_t operator()(std::string_view key) const; };
+	struct product_hasher { uint64_t operator()(std::string_view key) const; };
+	struct my_hasher { uint64_t operator()(std::string_view key) const; };
 
 // PRIVATE DATA
 private:
+	// Starting size of every table tested
+	int tableSize;
 	// The hash table to test
-	hash_table<int> table;
+	hash_table<int, general_hasher> table;
+	// Open-addressing table to compare against the chained table
+	flat_hash_table<int, general_hasher> flatTable;
 
 public:
-	hash_table_test_application(int tableSize) : table(tableSize, general_hasher()) {}
+	hash_table_test_application(int tableSize) :
+		tableSize(tableSize), table(tableSize), flatTable(tableSize) {}
 
 	// Test the functions in the hash table with the general hasher - insertion, finding, and deletion
 	void report_hash_table_algorithm_stats(std::ostream&, const std::string* inputFiles,
@@ -33,16 +45,25 @@ public:
 	// Test the hash table's efficiency given different hashing functions
 	void report_different_hasher_stats(std::ostream&, const char*, int numElements);
 
+	// Report how many gigabytes per second each hasher hashes for keys of different lengths
+	void report_hasher_throughput(std::ostream&, const int* keyLengths, int totalKeyLengths);
+
+	// Compare the chained table against the open-addressing table with the general hasher
+	void report_flat_table_comparison(std::ostream&, const char*, int numElements);
+
 	// Output all given stats for the hash function
 	void output_hash_table_stats(std::ostream&, const std::string& hasherName,
 			hash_table_analyzer::hash_table_stats stats);
+
+	// Output all given stats for the open-addressing table
+	void output_flat_table_stats(std::ostream&, const std::string& tableName,
+			hash_table_analyzer::flat_hash_table_stats stats);
+
 protected:
-	// Different hash functions for the hash table
-	static hasher general_hasher();
-	static hasher bit_shift_hasher();
-	static hasher sum_hasher();
-	static hasher product_hasher();
-	static hasher my_hasher();
+	// Output the stats of a new table that hashes with the given hasher type
+	template<typename Hasher>
+	void report_hasher_stats(std::ostream&, const std::string& hasherName,
+			const char* filename, int numElements);
 };
 
 #endif /* HASH_TABLE_TEST_APPLICATION_H_ */
@@ -20,6 +20,9 @@ const std::string INPUT_FILES[TOTAL_INPUT_FILES] = {
 	"random.txt",
 	"words.txt"
 };
+// Key lengths to measure hasher throughput for
+const int TOTAL_KEY_LENGTHS = 4;
+const int KEY_LENGTHS[TOTAL_KEY_LENGTHS] = { 8, 32, 256, 4096 };
 
 int main()
 {
@@ -27,5 +30,10 @@ int main()
 	app.report_hash_table_algorithm_stats(cout, INPUT_FILES, TOTAL_INPUT_FILES,
 			TOTAL_PARTITIONS, MAX_INPUT_SIZE);
 	app.report_different_hasher_stats(cout, "random.txt", MAX_INPUT_SIZE);
+	app.report_hasher_throughput(cout, KEY_LENGTHS, TOTAL_KEY_LENGTHS);
+	for(int i = 0; i < TOTAL_INPUT_FILES; i++)
+	{
+		app.report_flat_table_comparison(cout, INPUT_FILES[i].c_str(), MAX_INPUT_SIZE);
+	}
 	return 0;
 }
@@ -0,0 +1,231 @@
+/*
+ * string_hashers.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: chuntting0
+ */
+
+#include "string_hashers.h"
+#include <random>
+using namespace std;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STRING_HASHERS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	// Each stripe mixes 64 bytes into eight 64-bit accumulators
+	const size_t STRIPE_BYTES = 64;
+	const size_t LANES = 8;
+	// The accumulators are scrambled after every block of stripes
+	const size_t STRIPES_PER_BLOCK = 16;
+	const uint64_t SCRAMBLE_PRIME = 0x9E3779B1ull;
+
+	// Per-lane constants xor'ed into the key before each multiply
+	alignas(32) const uint64_t SECRET[LANES] = {
+		0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+		0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull
+	};
+
+	// Multiply the low and high halves of each lane's keyed word, and add
+	// the neighboring lane's raw word so no input bits are lost to the multiply
+	void accumulate(uint64_t* acc, const unsigned char* stripe)
+	{
+		for(size_t i = 0; i < LANES; i++)
+		{
+			uint64_t data;
+			memcpy(&data, stripe + i * 8, 8);
+			uint64_t keyed = data ^ SECRET[i];
+			acc[i ^ 1] += data;
+			acc[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+		}
+	}
+
+	void scramble(uint64_t* acc)
+	{
+		for(size_t i = 0; i < LANES; i++)
+		{
+			acc[i] = (acc[i] ^ (acc[i] >> 47) ^ SECRET[i]) * SCRAMBLE_PRIME;
+		}
+	}
+
+	void accumulate_stripes(uint64_t* acc, const unsigned char* bytes, size_t stripes)
+	{
+		for(size_t stripe = 0; stripe < stripes; stripe++)
+		{
+			accumulate(acc, bytes + stripe * STRIPE_BYTES);
+			if((stripe + 1) % STRIPES_PER_BLOCK == 0)
+			{
+				scramble(acc);
+			}
+		}
+	}
+
+#ifdef STRING_HASHERS_AVX2
+	// accumulate and scramble for four lanes held in one register
+	__attribute__((target("avx2")))
+	__m256i accumulate_lanes(__m256i acc, __m256i data, __m256i secret)
+	{
+		__m256i keyed = _mm256_xor_si256(data, secret);
+		__m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+		// Swap neighboring 64-bit lanes so each lane adds its neighbor's word
+		__m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		return _mm256_add_epi64(acc, _mm256_add_epi64(product, swapped));
+	}
+
+	__attribute__((target("avx2")))
+	__m256i scramble_lanes(__m256i acc, __m256i secret)
+	{
+		const __m256i prime = _mm256_set1_epi64x(SCRAMBLE_PRIME);
+		acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+		acc = _mm256_xor_si256(acc, secret);
+		// 64-bit multiply by a 32-bit prime from two 32-bit multiplies
+		__m256i productLow = _mm256_mul_epu32(acc, prime);
+		__m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prime);
+		return _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32));
+	}
+
+	// Same as accumulate_stripes, four lanes per register
+	__attribute__((target("avx2")))
+	void accumulate_stripes_avx2(uint64_t* acc, const unsigned char* bytes, size_t stripes)
+	{
+		__m256i low = _mm256_loadu_si256((const __m256i*)acc);
+		__m256i high = _mm256_loadu_si256((const __m256i*)(acc + 4));
+		const __m256i secretLow = _mm256_load_si256((const __m256i*)SECRET);
+		const __m256i secretHigh = _mm256_load_si256((const __m256i*)(SECRET + 4));
+
+		for(size_t stripe = 0; stripe < stripes; stripe++)
+		{
+			const unsigned char* from = bytes + stripe * STRIPE_BYTES;
+			low = accumulate_lanes(low, _mm256_loadu_si256((const __m256i*)from), secretLow);
+			high = accumulate_lanes(high, _mm256_loadu_si256((const __m256i*)(from + 32)), secretHigh);
+			if((stripe + 1) % STRIPES_PER_BLOCK == 0)
+			{
+				low = scramble_lanes(low, secretLow);
+				high = scramble_lanes(high, secretHigh);
+			}
+		}
+
+		_mm256_storeu_si256((__m256i*)acc, low);
+		_mm256_storeu_si256((__m256i*)(acc + 4), high);
+	}
+#endif /* STRING_HASHERS_AVX2 */
+}
+
+bool fast_hasher::vectorized()
+{
+#ifdef STRING_HASHERS_AVX2
+	static const bool avx2 = __builtin_cpu_supports("avx2");
+	return avx2;
+#else
+	return false;
+#endif
+}
+
+uint64_t fast_hasher::hash_long(const unsigned char* bytes, size_t length, uint64_t seed)
+{
+	uint64_t acc[LANES];
+	for(size_t i = 0; i < LANES; i++)
+	{
+		acc[i] = SECRET[i] ^ seed;
+	}
+
+	// Leave at least one byte for the final stripe,
+	// which overlaps the end of the last full stripe
+	size_t stripes = (length - 1) / STRIPE_BYTES;
+#ifdef STRING_HASHERS_AVX2
+	if(vectorized())
+	{
+		accumulate_stripes_avx2(acc, bytes, stripes);
+	}
+	else
+#endif
+	{
+		accumulate_stripes(acc, bytes, stripes);
+	}
+	accumulate(acc, bytes + length - STRIPE_BYTES);
+
+	// Fold the accumulators down to one word
+	uint64_t result = length * PRIME0;
+	for(size_t i = 0; i < LANES; i += 2)
+	{
+		result += mix(acc[i] ^ PRIME1, acc[i + 1] ^ seed);
+	}
+	return mix(result ^ PRIME2, seed ^ PRIME3);
+}
+
+namespace
+{
+	// SipHash-1-3: one round per word of input, three to finish
+	const int COMPRESSION_ROUNDS = 1;
+	const int FINALIZATION_ROUNDS = 3;
+
+	uint64_t rotate_left(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3)
+	{
+		v0 += v1; v1 = rotate_left(v1, 13); v1 ^= v0; v0 = rotate_left(v0, 32);
+		v2 += v3; v3 = rotate_left(v3, 16); v3 ^= v2;
+		v0 += v3; v3 = rotate_left(v3, 21); v3 ^= v0;
+		v2 += v1; v1 = rotate_left(v1, 17); v1 ^= v2; v2 = rotate_left(v2, 32);
+	}
+}
+
+seeded_hasher::seeded_hasher()
+{
+	random_device device;
+	key0 = ((uint64_t)device() << 32) | device();
+	key1 = ((uint64_t)device() << 32) | device();
+}
+
+uint64_t seeded_hasher::operator()(string_view key) const
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(key.data());
+	size_t length = key.size();
+	uint64_t v0 = key0 ^ 0x736f6d6570736575ull;
+	uint64_t v1 = key1 ^ 0x646f72616e646f6dull;
+	uint64_t v2 = key0 ^ 0x6c7967656e657261ull;
+	uint64_t v3 = key1 ^ 0x7465646279746573ull;
+
+	// Compress each full little-endian word
+	size_t fullWords = length / 8;
+	for(size_t i = 0; i < fullWords; i++)
+	{
+		uint64_t word = 0;
+		for(int j = 7; j >= 0; j--)
+		{
+			word = (word << 8) | bytes[i * 8 + j];
+		}
+		v3 ^= word;
+		for(int round = 0; round < COMPRESSION_ROUNDS; round++)
+		{
+			sip_round(v0, v1, v2, v3);
+		}
+		v0 ^= word;
+	}
+
+	// The last word holds the leftover bytes and the low byte of the length
+	uint64_t last = (uint64_t)length << 56;
+	for(size_t j = 0; j < length % 8; j++)
+	{
+		last |= (uint64_t)bytes[fullWords * 8 + j] << (8 * j);
+	}
+	v3 ^= last;
+	for(int round = 0; round < COMPRESSION_ROUNDS; round++)
+	{
+		sip_round(v0, v1, v2, v3);
+	}
+	v0 ^= last;
+
+	v2 ^= 0xff;
+	for(int round = 0; round < FINALIZATION_ROUNDS; round++)
+	{
+		sip_round(v0, v1, v2, v3);
+	}
+	return v0 ^ v1 ^ v2 ^ v3;
+}
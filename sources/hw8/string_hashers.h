@@ -0,0 +1,158 @@
+/*
+ * string_hashers.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: chuntting0
+ */
+
+#ifndef STRING_HASHERS_H_
+#define STRING_HASHERS_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Fast 64-bit string hash in the style of wyhash. Keys are consumed
+// 16 bytes per step, or 48 bytes per step across three independent
+// lanes once they are longer than 48 bytes, and every step folds a
+// full 64x64 -> 128 bit multiply. Keys of LONG_KEY_BYTES or more go
+// through an xxh3-style striped loop that runs on AVX2 when the CPU
+// has it. Both paths of the striped loop give the same hash.
+//
+// Different seeds give different hashes, but the function is not keyed strongly
+// enough to stop someone who can choose keys from forcing collisions.
+// Use seeded_hasher for keys that come from untrusted input
+class fast_hasher
+{
+// PUBLIC DATA
+public:
+	// Keys at least this long use the striped loop
+	static constexpr size_t LONG_KEY_BYTES = 256;
+
+// PRIVATE DATA
+private:
+	uint64_t seed;
+
+// PUBLIC INTERFACE
+public:
+	fast_hasher(uint64_t seed = 0) : seed(seed) {}
+
+	uint64_t operator()(std::string_view key) const;
+
+	// Return true if this CPU runs the vector striped loop
+	static bool vectorized();
+
+// PROTECTED UTILITIES
+protected:
+	static constexpr uint64_t PRIME0 = 0xa0761d6478bd642full;
+	static constexpr uint64_t PRIME1 = 0xe7037ed1a0b428dbull;
+	static constexpr uint64_t PRIME2 = 0x8ebc6af09c88c6e3ull;
+	static constexpr uint64_t PRIME3 = 0x589965cc75374cc3ull;
+
+	// Multiply into 128 bits and fold the halves together
+	static uint64_t mix(uint64_t a, uint64_t b)
+	{
+		unsigned __int128 product = (unsigned __int128)a * b;
+		return (uint64_t)product ^ (uint64_t)(product >> 64);
+	}
+
+	static uint64_t read64(const unsigned char* bytes) { uint64_t value; std::memcpy(&value, bytes, 8); return value; }
+	static uint64_t read32(const unsigned char* bytes) { uint32_t value; std::memcpy(&value, bytes, 4); return value; }
+
+	// Hash keys of LONG_KEY_BYTES or more
+	static uint64_t hash_long(const unsigned char* bytes, size_t length, uint64_t seed);
+};
+
+// Keyed 64-bit string hash for tables whose keys come from untrusted
+// input. This is SipHash-1-3 with a 128-bit key: without the key,
+// finding keys that collide is as hard as breaking the hash, so an
+// attacker cannot flood a single chain. Default-constructed hashers
+// draw their key from std::random_device
+class seeded_hasher
+{
+// PRIVATE DATA
+private:
+	uint64_t key0;
+	uint64_t key1;
+
+// PUBLIC INTERFACE
+public:
+	// Use a random key
+	seeded_hasher();
+
+	// Use the given key, for hashes that must be reproducible
+	seeded_hasher(uint64_t key0, uint64_t key1) : key0(key0), key1(key1) {}
+
+	uint64_t operator()(std::string_view key) const;
+};
+
+inline uint64_t fast_hasher::operator()(std::string_view key) const
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(key.data());
+	size_t length = key.size();
+	uint64_t state = seed ^ mix(seed ^ PRIME0, PRIME1);
+	uint64_t a;
+	uint64_t b;
+
+	if(length <= 16)
+	{
+		// Short keys are read as two possibly overlapping words
+		if(length >= 4)
+		{
+			size_t middle = (length >> 3) << 2;
+			a = (read32(bytes) << 32) | read32(bytes + middle);
+			b = (read32(bytes + length - 4) << 32) | read32(bytes + length - 4 - middle);
+		}
+		else if(length > 0)
+		{
+			a = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[length >> 1] << 8) | bytes[length - 1];
+			b = 0;
+		}
+		else
+		{
+			a = 0;
+			b = 0;
+		}
+	}
+	else if(length >= LONG_KEY_BYTES)
+	{
+		return hash_long(bytes, length, state);
+	}
+	else
+	{
+		size_t remaining = length;
+
+		// Run three lanes in parallel so the multiplies overlap
+		if(remaining > 48)
+		{
+			uint64_t lane1 = state;
+			uint64_t lane2 = state;
+			do
+			{
+				state = mix(read64(bytes) ^ PRIME1, read64(bytes + 8) ^ state);
+				lane1 = mix(read64(bytes + 16) ^ PRIME2, read64(bytes + 24) ^ lane1);
+				lane2 = mix(read64(bytes + 32) ^ PRIME3, read64(bytes + 40) ^ lane2);
+				bytes += 48;
+				remaining -= 48;
+			}
+			while(remaining > 48);
+			state ^= lane1 ^ lane2;
+		}
+
+		while(remaining > 16)
+		{
+			state = mix(read64(bytes) ^ PRIME1, read64(bytes + 8) ^ state);
+			bytes += 16;
+			remaining -= 16;
+		}
+
+		// The last 16 bytes of the key, overlapping bytes already hashed if needed
+		a = read64(bytes + remaining - 16);
+		b = read64(bytes + remaining - 8);
+	}
+
+	unsigned __int128 product = (unsigned __int128)(a ^ PRIME1) * (b ^ state);
+	return mix((uint64_t)product ^ PRIME0 ^ length, (uint64_t)(product >> 64) ^ PRIME1);
+}
+
+#endif /* STRING_HASHERS_H_ */